@@ -0,0 +1,6 @@
+// Minimal replacement of Arduino.h for the PC test of RTC_Calendar.h
+#pragma once
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_word(p) (*(const uint16_t*)(p))
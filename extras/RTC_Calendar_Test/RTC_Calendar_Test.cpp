@@ -0,0 +1,70 @@
+/*
+ PC test of the calendar functions in src/RTC_Calendar.h
+
+ Every day from 2000 to 2099, every second of a day and random times are compared with gmtime()
+ and timegm() of the C library. The summer time is compared every 30 minutes with localtime() and
+ the rule "CET-1CEST,M3.5.0,M10.5.0/3". The test runs on the PC because it takes too long on the
+ Arduino. Arduino.h and TimeLib.h in this directory are minimal replacements.
+
+ Compile and run (Linux):
+   cd extras/RTC_Calendar_Test
+   g++ -std=gnu++11 -I. -I../../src RTC_Calendar_Test.cpp -o RTC_Calendar_Test && ./RTC_Calendar_Test
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <RTC_Calendar.h>
+
+static uint32_t Errors = 0;
+
+//------------------------------
+static void Check_Time(time_t t)
+//------------------------------
+{
+  struct tm g;
+  gmtime_r(&t, &g);
+  tmElements_t tm;
+  RTC_Break_Time(t, tm);
+  if (tm.Year != g.tm_year - 70 || tm.Month  != g.tm_mon + 1 || tm.Day    != g.tm_mday || tm.Wday != g.tm_wday + 1 ||
+      tm.Hour != g.tm_hour      || tm.Minute != g.tm_min     || tm.Second != g.tm_sec  || RTC_Make_Time(tm) != t)
+     {
+     if (Errors++ < 10) printf("Calendar error at %ld\n", (long)t);
+     }
+}
+
+//-----------------------------------
+static bool Summer_Time_Ref(time_t t)
+//-----------------------------------
+// t is the normal time (MEZ = UTC+1) like in the RTC
+{
+  time_t Utc = t - 3600;
+  struct tm l;
+  localtime_r(&Utc, &l);
+  return l.tm_isdst > 0;
+}
+
+//--------
+int main()
+//--------
+{
+  setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+  tzset();
+  for (uint32_t Days = 0; Days < 36525; Days++)                           // Every day at different times
+      Check_Time(RTC_CAL_EPOCH + Days * RTC_CAL_DAY + (Days * 4409UL) % RTC_CAL_DAY);
+  for (uint32_t s = 0; s < RTC_CAL_DAY; s++)                              // Every second of a day
+      Check_Time(RTC_CAL_EPOCH + 7305 * RTC_CAL_DAY + s);
+  srand(1);
+  for (uint32_t i = 0; i < 1000000; i++)                                  // Random times => Also the cache of RTC_Break_Time()
+      Check_Time(RTC_CAL_EPOCH + (((uint32_t)rand() << 16) ^ rand()) % (RTC_CAL_END - RTC_CAL_EPOCH));
+  printf("Calendar: %u errors\n", Errors);
+
+  uint32_t Summer_Errors = 0;
+  for (time_t t = RTC_CAL_EPOCH; t < (time_t)RTC_CAL_END; t += 1800)      // Includes the switching times at 2:00 MEZ
+      for (time_t x = t - 1; x <= t; x++)
+          if (RTC_Summer_Time(x) != Summer_Time_Ref(x))
+             {
+             if (Summer_Errors++ < 10) printf("Summer time error at %ld\n", (long)x);
+             }
+  printf("Summer time: %u errors\n", Summer_Errors);
+  return Errors || Summer_Errors;
+}
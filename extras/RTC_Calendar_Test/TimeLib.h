@@ -0,0 +1,23 @@
+// Minimal replacement of the Time library for the PC test of RTC_Calendar.h
+// makeTime() and breakTime() are only used outside of 2000..2099.
+#pragma once
+#include <stdint.h>
+#include <time.h>
+
+typedef struct { uint8_t Second, Minute, Hour, Wday, Day, Month, Year; } tmElements_t;  // Wday: 1 = sunday, Year: Offset from 1970
+
+inline void breakTime(time_t t, tmElements_t &tm)
+{
+  struct tm g;
+  gmtime_r(&t, &g);
+  tm.Second = g.tm_sec;  tm.Minute = g.tm_min;     tm.Hour = g.tm_hour;        tm.Wday = g.tm_wday + 1;
+  tm.Day    = g.tm_mday; tm.Month  = g.tm_mon + 1; tm.Year = g.tm_year - 70;
+}
+
+inline time_t makeTime(const tmElements_t &tm)
+{
+  struct tm g = {};
+  g.tm_sec  = tm.Second; g.tm_min = tm.Minute;    g.tm_hour = tm.Hour;
+  g.tm_mday = tm.Day;    g.tm_mon = tm.Month - 1; g.tm_year = tm.Year + 70;
+  return timegm(&g);
+}
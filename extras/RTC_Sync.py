@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+RTC_Sync.py: Set the RealTimeClockMLX to the time of the PC with an accuracy better than 100 ms
+
+ Usage:  python RTC_Sync.py COM3            Set the clock
+         python RTC_Sync.py COM3 --check    Only show the difference
+
+ Protocol (115200 Baud, one command per line):
+  S?            The clock answers "S=sec.ms" = time at the reception of the command
+  S=sec.ms      Set the clock. The time is valid at the reception of the command.
+                The clock answers "S=OK" and writes the RTC at the next second boundary.
+ sec = Seconds since 1.1.1970 in MEZ (Winter time). The RTC is always set to winter time.
+
+ The round trip time of "S?" is measured several times. The sample with the shortest
+ round trip is used because it has the smallest unknown delay. The time is assumed to be
+ read in the middle of the round trip.
+
+ Requires pyserial (pip install pyserial)
+"""
+
+import argparse
+import sys
+import time
+
+import serial
+
+TZ_OFFSET = 3600  # MEZ (Winter time) - UTC [s]
+
+
+def read_answer(port, timeout=1.0):
+    """Return the next line starting with "S=" (Other messages of the clock are skipped)"""
+    end = time.monotonic() + timeout
+    while time.monotonic() < end:
+        line = port.readline().decode("latin-1", "replace").strip()
+        if line.startswith("S="):
+            return line[2:]
+    return None
+
+
+def measure(port, samples):
+    """Returns (offset [s], round trip [s]) of the sample with the shortest round trip.
+       offset = clock - PC"""
+    best = None
+    for _ in range(samples):
+        port.reset_input_buffer()
+        t0 = time.time()
+        port.write(b"S?\n")
+        port.flush()
+        ans = read_answer(port)
+        t1 = time.time()
+        if ans is None:
+            continue
+        try:
+            dev = float(ans)
+        except ValueError:
+            continue
+        rtt = t1 - t0
+        offset = dev - ((t0 + t1) / 2 + TZ_OFFSET)
+        if best is None or rtt < best[1]:
+            best = (offset, rtt)
+        time.sleep(0.05)
+    return best
+
+
+def set_clock(port, rtt):
+    """Send the time which is valid when the command arrives at the clock"""
+    port.reset_input_buffer()
+    t = time.time() + TZ_OFFSET + rtt / 2
+    sec = int(t)
+    port.write(("S=%d.%03d\n" % (sec, int((t - sec) * 1000))).encode("ascii"))
+    port.flush()
+    return read_answer(port) == "OK"
+
+
+def main():
+    par = argparse.ArgumentParser(description="Set the RealTimeClockMLX to the PC time")
+    par.add_argument("port", help="Serial port (Example: COM3, /dev/ttyUSB0)")
+    par.add_argument("--baud", type=int, default=115200)
+    par.add_argument("--samples", type=int, default=8, help="Number of round trip measurements")
+    par.add_argument("--check", action="store_true", help="Only show the difference")
+    par.add_argument("--no-wait", action="store_true", help="Don't wait for the restart after opening the port")
+    args = par.parse_args()
+
+    with serial.Serial(args.port, args.baud, timeout=0.2) as port:
+        if not args.no_wait:
+            time.sleep(2.5)  # Opening the port resets the Arduino
+
+        best = measure(port, args.samples)
+        if best is None:
+            sys.exit("No answer from the clock. Is the RS232 input of the MobaLedLib disabled?")
+        print("Difference: %+.3f s  (Round trip %.1f ms)" % (best[0], best[1] * 1000))
+        if args.check:
+            return
+
+        if not set_clock(port, best[1]):
+            sys.exit("Setting the clock failed")
+        time.sleep(1.5)  # The RTC is written at the next second boundary
+
+        best = measure(port, args.samples)
+        if best is None:
+            sys.exit("No answer from the clock after setting the time")
+        print("Clock set. Remaining difference: %+.3f s" % best[0])
+
+
+if __name__ == "__main__":
+    main()
@@ -7,24 +7,65 @@
 // and DS3231 Real-Time Clocks.
 
 #include <DS3232RTC_Include.h>
+#include <RTC_Calendar.h>     // Division free makeTime()/breakTime() for 2000..2099
 
 uint8_t DS3232RTC::errCode;
+#if defined(DS32_TWOWIRE)
+TwoWire *DS3232RTC::bus = &Wire;
+#endif
 
-// Initialize the I2C bus.
+// Initialize the I2C bus. A timeout is set (if supported by the Wire
+// library) so that a stuck bus or a missing RTC doesn't block the caller.
 void DS3232RTC::begin()
 {
     i2cBegin();
+    setTimeout();
+}
+
+#if defined(DS32_TWOWIRE)
+// Initialize the RTC on the given I2C bus (e.g. Wire1 on the ESP32)
+// with the given clock. The bus is used for all further transfers.
+// The clock applies to all devices on this bus.
+void DS3232RTC::begin(TwoWire &wire, uint32_t clock)
+{
+    bus = &wire;
+    i2cBegin();
+    bus->setClock(clock);
+    setTimeout();
+}
+
+#if defined(ESP32)
+// Same as above with the SDA and SCL pins of the ESP32 I2C controller.
+// Pins < 0 select the default pins of the controller.
+void DS3232RTC::begin(TwoWire &wire, int sda, int scl, uint32_t clock)
+{
+    bus = &wire;
+    bus->begin(sda, scl, clock);
+    setTimeout();
+}
+#endif
+#endif
+
+// Set the timeout of the I2C bus if supported by the Wire library
+void DS3232RTC::setTimeout()
+{
+#if defined(DS32_TWOWIRE) && defined(WIRE_HAS_TIMEOUT)
+    bus->setWireTimeout(DS32_I2C_TIMEOUT_MS * 1000UL, true);
+#elif defined(DS32_TWOWIRE) && defined(ESP32)
+    bus->setTimeOut(DS32_I2C_TIMEOUT_MS);
+#endif
 }
 
 // Read the current time from the RTC and return it as a time_t
 // value. Returns a zero value if an I2C error occurred (e.g. RTC
-// not present).
+// not present) or the registers contain an invalid time. The reason
+// is stored in errCode.
 time_t DS3232RTC::get()
 {
     tmElements_t tm;
 
     if ( read(tm) ) return 0;
-    return( makeTime(tm) );
+    return( RTC_Make_Time(tm) );
 }
 
 // Set the RTC to the given time_t value and clear the
@@ -34,26 +75,35 @@ uint8_t DS3232RTC::set(time_t t)
 {
     tmElements_t tm;
 
-    breakTime(t, tm);
+    RTC_Break_Time(t, tm);
     return ( write(tm) );
 }
 
 // Read the current time from the RTC and return it in a tmElements_t
-// structure. Returns the I2C status (zero if successful).
+// structure. Returns the I2C status (zero if successful),
+// DS32_ERR_COUNT if not all bytes were received or DS32_ERR_RANGE if
+// a register contains an invalid value (e.g. noise on the bus).
+// tm is only changed if the read was successful.
 uint8_t DS3232RTC::read(tmElements_t &tm)
 {
-    i2cBeginTransmission(DS32_ADDR);
-    i2cWrite(DS32_SECONDS);
-    if ( uint8_t e = i2cEndTransmission() ) { errCode = e; return e; }
-    // request 7 bytes (secs, min, hr, dow, date, mth, yr)
-    i2cRequestFrom(DS32_ADDR, static_cast<uint8_t>(tmNbrFields));
-    tm.Second = bcd2dec(i2cRead() & ~_BV(DS1307_CH));
-    tm.Minute = bcd2dec(i2cRead());
-    tm.Hour = bcd2dec(i2cRead() & ~_BV(DS32_HR1224));   // assumes 24hr clock
-    tm.Wday = i2cRead();
-    tm.Day = bcd2dec(i2cRead());
-    tm.Month = bcd2dec(i2cRead() & ~_BV(DS32_CENTURY)); // don't use the Century bit
-    tm.Year = y2kYearToTm(bcd2dec(i2cRead()));
+    uint8_t r[tmNbrFields];     // secs, min, hr, dow, date, mth, yr
+    if ( uint8_t e = readRTC(DS32_SECONDS, r, tmNbrFields) ) return e;
+    r[0] &= ~_BV(DS1307_CH);
+    r[2] &= ~_BV(DS32_HR1224);  // assumes 24hr clock
+    r[5] &= ~_BV(DS32_CENTURY); // don't use the Century bit
+    if ( !bcdValid(r[0], 0, 59) || !bcdValid(r[1], 0, 59) || !bcdValid(r[2], 0, 23) || r[3] < 1 || r[3] > 7 ||
+         !bcdValid(r[4], 1, 31) || !bcdValid(r[5], 1, 12) || !bcdValid(r[6], 0, 99) )
+    {
+        errCode = DS32_ERR_RANGE;
+        return errCode;
+    }
+    tm.Second = bcd2dec(r[0]);
+    tm.Minute = bcd2dec(r[1]);
+    tm.Hour = bcd2dec(r[2]);
+    tm.Wday = r[3];
+    tm.Day = bcd2dec(r[4]);
+    tm.Month = bcd2dec(r[5]);
+    tm.Year = y2kYearToTm(bcd2dec(r[6]));
     return 0;
 }
 
@@ -72,9 +122,10 @@ uint8_t DS3232RTC::write(tmElements_t &tm)
     i2cWrite(dec2bcd(tm.Month));
     i2cWrite(dec2bcd(tmYearToY2k(tm.Year)));
     uint8_t ret = i2cEndTransmission();
-    uint8_t s = readRTC(DS32_STATUS);               // read the status register
-    writeRTC( DS32_STATUS, s & ~_BV(DS32_OSF) );    // clear the Oscillator Stop Flag
-    return ret;
+    if (ret) { errCode = ret; return ret; }         // don't clear the OSF if the time was not written
+    uint8_t s;
+    if ( (ret = readRTC(DS32_STATUS, &s, 1)) ) return ret;  // read the status register
+    return writeRTC( DS32_STATUS, s & ~_BV(DS32_OSF) );     // clear the Oscillator Stop Flag
 }
 
 // Write multiple bytes to RTC RAM.
@@ -102,13 +153,18 @@ uint8_t DS3232RTC::writeRTC(uint8_t addr, uint8_t value)
 // Valid address range is 0x00 - 0xFF, no checking.
 // Number of bytes (nBytes) must be between 1 and 32 (Wire library
 // limitation).
-// Returns the I2C status (zero if successful).
+// Returns the I2C status (zero if successful) or DS32_ERR_COUNT if
+// less than nBytes were received. The error is also stored in errCode.
 uint8_t DS3232RTC::readRTC(uint8_t addr, uint8_t* values, uint8_t nBytes)
 {
     i2cBeginTransmission(DS32_ADDR);
     i2cWrite(addr);
-    if ( uint8_t e = i2cEndTransmission() ) return e;
-    i2cRequestFrom( (uint8_t)DS32_ADDR, nBytes );
+    if ( uint8_t e = i2cEndTransmission() ) { errCode = e; return e; }
+    if ( i2cRequestFrom( (uint8_t)DS32_ADDR, nBytes ) != nBytes )
+    {
+        errCode = DS32_ERR_COUNT;
+        return errCode;
+    }
     for (uint8_t i=0; i<nBytes; i++) values[i] = i2cRead();
     return 0;
 }
@@ -309,3 +365,11 @@ uint8_t __attribute__ ((noinline)) DS3232RTC::bcd2dec(uint8_t n)
     return n - 6 * (n >> 4);
 }
 
+// Check if n is a valid BCD number in the range lo..hi
+bool DS3232RTC::bcdValid(uint8_t n, uint8_t lo, uint8_t hi)
+{
+    if ( (n & 0x0F) > 9 || (n >> 4) > 9 ) return false;
+    n = bcd2dec(n);
+    return n >= lo && n <= hi;
+}
+
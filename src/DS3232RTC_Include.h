@@ -23,12 +23,13 @@
 #define i2cWrite TinyWireM.send
 #elif ARDUINO >= 100
 #include <Wire.h>
-#define i2cBegin Wire.begin
-#define i2cBeginTransmission Wire.beginTransmission
-#define i2cEndTransmission Wire.endTransmission
-#define i2cRequestFrom Wire.requestFrom
-#define i2cRead Wire.read
-#define i2cWrite Wire.write
+#define DS32_TWOWIRE        // the bus could be selected with begin(TwoWire&, ...)
+#define i2cBegin DS3232RTC::bus->begin
+#define i2cBeginTransmission DS3232RTC::bus->beginTransmission
+#define i2cEndTransmission DS3232RTC::bus->endTransmission
+#define i2cRequestFrom DS3232RTC::bus->requestFrom
+#define i2cRead DS3232RTC::bus->read
+#define i2cWrite DS3232RTC::bus->write
 #else
 #include <Wire.h>
 #define i2cBegin Wire.begin
@@ -47,6 +48,14 @@
 #define BUFFER_LENGTH 32
 #endif
 
+#ifndef DS32_I2C_TIMEOUT_MS // maximum time an I2C transfer may block if the bus is stuck
+#define DS32_I2C_TIMEOUT_MS 10
+#endif
+
+#ifndef DS32_I2C_CLOCK      // default for begin(TwoWire&, ...), the DS3231/DS3232 support also 400000UL (fast mode)
+#define DS32_I2C_CLOCK 100000UL
+#endif
+
 class DS3232RTC
 {
     public:
@@ -131,16 +140,29 @@ class DS3232RTC
             DS32_CENTURY     {7},        // Century bit in Month register
             DS32_DYDT        {6};        // Day/Date flag bit in alarm Day/Date registers
 
+        // Error codes in addition to the I2C status of endTransmission() (1..5)
+        static constexpr uint8_t
+            DS32_ERR_COUNT   {0x10},     // less bytes received than requested
+            DS32_ERR_RANGE   {0x11},     // invalid BCD digit or time field out of range
+            DS32_ERR_OSF     {0x12};     // oscillator stop flag set, time is invalid
+
         DS3232RTC() {};
         DS3232RTC(bool initI2C) { (void)initI2C; }  // undocumented for backward compatibility
         void begin();
+#if defined(DS32_TWOWIRE)
+        void begin(TwoWire &wire, uint32_t clock = DS32_I2C_CLOCK);
+#if defined(ESP32)
+        void begin(TwoWire &wire, int sda, int scl, uint32_t clock = DS32_I2C_CLOCK);
+#endif
+        static TwoWire *bus;    // I2C bus used by the i2c... macros, default is Wire
+#endif
         static time_t get();    // static needed to work with setSyncProvider() in the Time library
         uint8_t set(time_t t);
         static uint8_t read(tmElements_t &tm);
         uint8_t write(tmElements_t &tm);
         uint8_t writeRTC(uint8_t addr, uint8_t* values, uint8_t nBytes);
         uint8_t writeRTC(uint8_t addr, uint8_t value);
-        uint8_t readRTC(uint8_t addr, uint8_t* values, uint8_t nBytes);
+        static uint8_t readRTC(uint8_t addr, uint8_t* values, uint8_t nBytes);  // static needed for read()
         uint8_t readRTC(uint8_t addr);
         void setAlarm(ALARM_TYPES_t  alarmType, uint8_t seconds,  uint8_t  minutes, uint8_t  hours, uint8_t  daydate);
         void setAlarm(ALARM_TYPES_t  alarmType,                   uint8_t  minutes, uint8_t  hours, uint8_t  daydate);
@@ -156,8 +178,10 @@ class DS3232RTC
         static uint8_t errCode;
 
     private:
+        void setTimeout();
         uint8_t dec2bcd(uint8_t n);
         static uint8_t bcd2dec(uint8_t n);
+        static bool bcdValid(uint8_t n, uint8_t lo, uint8_t hi);
 };
 
 #endif
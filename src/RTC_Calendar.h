@@ -0,0 +1,159 @@
+/*
+ Kalender Funktionen fr die Jahre 2000 bis 2099
+
+ Ersetzt makeTime(), breakTime() und summertime_RAMsave() im Hauptprogramm. Die Funktionen der
+ Time Library verwenden Schleifen ber die Jahre und Monate und viele Divisionen. Das kostet auf
+ dem ATMega328 sehr viel Zeit.
+ Hier werden die Tage direkt berechnet. Divisionen durch Konstanten werden durch Multiplikation
+ und Verschieben ersetzt. Die Aufteilung in Datum und Uhrzeit wird fr den aktuellen Tag zwischen
+ gespeichert => Nur einmal am Tag wird eine echte Division ausgefhrt. Die Umschaltzeiten der
+ Sommerzeit werden einmal im Jahr berechnet.
+
+ Auerhalb von 2000 bis 2099 werden die Funktionen der Time Library verwendet.
+ Der Test extras/RTC_Calendar_Test vergleicht auf dem PC alle Tage von 2000 bis 2099 mit gmtime()
+ und timegm() der C Library und prft die Umschaltzeiten der Sommerzeit.
+
+ Revision History:
+ ~~~~~~~~~~~~~~~~~
+ 19.10.26:  - Started
+*/
+
+#ifndef __RTC_CALENDAR__
+#define __RTC_CALENDAR__
+
+#include <Arduino.h>
+#include <TimeLib.h>        // https://github.com/PaulStoffregen/Time
+
+#define RTC_CAL_EPOCH   946684800UL  // 01.01.2000 00:00:00
+#define RTC_CAL_END     4102444800UL // 01.01.2100 00:00:00
+#define RTC_CAL_DAY     86400UL
+
+// Multiply-shift division by constants. The factors are exact in the used ranges
+// (Checked with extras/RTC_Calendar_Test)
+#define RTC_CAL_DIV1461(x)   (((uint32_t)(x) * 22967) >> 25)  // x < 36525  (Days in a 4 year cycle)
+#define RTC_CAL_DIV365(x)    (((uint32_t)(x) * 2873) >> 20)   // x < 1461
+#define RTC_CAL_DIV7(x)      (((uint32_t)(x) * 74899) >> 19)  // x < 36531
+#define RTC_CAL_DIV3600(x)   (((uint32_t)(x) * 37283) >> 27)  // x < 86400
+#define RTC_CAL_DIV60(x)     (((uint32_t)(x) * 17477) >> 20)  // x < 3600
+
+// Days before the month in a normal year
+const PROGMEM uint16_t RTC_Cal_Month_Days[13] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 };
+
+//-----------------------------------------------------------------------------
+inline uint16_t RTC_Cal_Day_Of_Year(uint8_t Year2k, uint8_t Month, uint8_t Day)
+//-----------------------------------------------------------------------------
+// Day of the year starting with 0. Year2k = Year - 2000 (0..99)
+{
+  return pgm_read_word(&RTC_Cal_Month_Days[Month-1]) + Day - 1 + (Month > 2 && (Year2k & 3) == 0);
+}
+
+//----------------------------------------------------------------------
+inline uint16_t RTC_Cal_Days(uint8_t Year2k, uint8_t Month, uint8_t Day)
+//----------------------------------------------------------------------
+// Days since 01.01.2000. All years divisible by 4 are leap years in this range.
+{
+  return (uint16_t)Year2k * 365 + ((Year2k + 3) >> 2) + RTC_Cal_Day_Of_Year(Year2k, Month, Day);
+}
+
+//-------------------------------------------
+inline uint8_t RTC_Cal_Weekday(uint16_t Days)
+//-------------------------------------------
+// Weekday like the Time library: 1 = sunday. The 01.01.2000 was a saturday.
+{
+  uint16_t x = Days + 6;
+  return x - RTC_CAL_DIV7(x) * 7 + 1;
+}
+
+//--------------------------------------------------------
+inline void RTC_Cal_Civil(uint16_t Days, tmElements_t &tm)
+//--------------------------------------------------------
+// Convert the days since 01.01.2000 to Year, Month, Day and Wday
+{
+  uint16_t Cycle = RTC_CAL_DIV1461(Days);                      // 4 year cycle starting with a leap year
+  uint16_t r     = Days - Cycle * 1461;
+  uint8_t  Y     = 0;
+  bool     Leap_Day = (r == 59);                               // 29.2.
+  if (r >= 366)     { Y = RTC_CAL_DIV365(r - 1); r -= Y * 365 + 1; }
+  else if (r > 59)  r--;                                       // Leap year after the 29.2. => Continue like a normal year
+  if (Leap_Day)
+     {
+     tm.Month = 2;
+     tm.Day   = 29;
+     }
+  else {
+       uint8_t m = r >> 5;                                     // Month index is m or m+1
+       if (r >= pgm_read_word(&RTC_Cal_Month_Days[m+1])) m++;
+       tm.Month = m + 1;
+       tm.Day   = r - pgm_read_word(&RTC_Cal_Month_Days[m]) + 1;
+       }
+  tm.Year = Cycle * 4 + Y + 30;                                // Offset from 1970
+  tm.Wday = RTC_Cal_Weekday(Days);
+}
+
+//-------------------------------------------------
+inline time_t RTC_Make_Time(const tmElements_t &tm)
+//-------------------------------------------------
+// Replacement for makeTime()
+{
+  if (tm.Year < 30 || tm.Year >= 130) return makeTime(tm);
+  return RTC_CAL_EPOCH + RTC_Cal_Days(tm.Year - 30, tm.Month, tm.Day) * RTC_CAL_DAY +
+         tm.Hour * 3600UL + tm.Minute * 60 + tm.Second;
+}
+
+//----------------------------------------------------
+inline void RTC_Break_Time(time_t t, tmElements_t &tm)
+//----------------------------------------------------
+// Replacement for breakTime(). The date is only calculated if the day changes.
+{
+  static uint32_t     Day_Start = 0;                           // 0 = Not valid because it's before 2000
+  static tmElements_t Day_tm;
+  if ((uint32_t)t < RTC_CAL_EPOCH || (uint32_t)t >= RTC_CAL_END) { breakTime(t, tm); return; }
+  uint32_t Sec_Of_Day = (uint32_t)t - Day_Start;
+  if (Sec_Of_Day >= RTC_CAL_DAY)                               // Overflow save. Also if t < Day_Start
+     {
+     uint16_t Days = ((uint32_t)t - RTC_CAL_EPOCH) / RTC_CAL_DAY;   // The only division
+     Day_Start  = RTC_CAL_EPOCH + Days * RTC_CAL_DAY;
+     Sec_Of_Day = (uint32_t)t - Day_Start;
+     RTC_Cal_Civil(Days, Day_tm);
+     }
+  tm = Day_tm;
+  tm.Hour   = RTC_CAL_DIV3600(Sec_Of_Day);
+  uint16_t r = Sec_Of_Day - tm.Hour * 3600UL;
+  tm.Minute = RTC_CAL_DIV60(r);
+  tm.Second = r - tm.Minute * 60;
+}
+
+//-----------------------------------------------------------------------------
+inline uint32_t RTC_Cal_Last_Sunday(uint8_t Year2k, uint8_t Month, uint8_t Day)
+//-----------------------------------------------------------------------------
+// Start of the last sunday on or before Day.Month in seconds since 1970
+{
+  uint16_t Days = RTC_Cal_Days(Year2k, Month, Day);
+  Days -= RTC_Cal_Weekday(Days) - 1;
+  return RTC_CAL_EPOCH + Days * RTC_CAL_DAY;
+}
+
+//-----------------------------------
+inline bool RTC_Summer_Time(time_t t)
+//-----------------------------------
+// European summer time. t is the normal time (MEZ) like it's stored in the RTC.
+// The summer time starts and ends at 2:00 MEZ on the last sunday of march/october.
+// Replacement for summertime_RAMsave(). The switching times are calculated once per year.
+{
+  static uint32_t Year_Start = 0, Year_End = 0;                // Empty range => Calculated at the first call
+  static uint32_t Summer_Start, Summer_End;
+  if ((uint32_t)t < RTC_CAL_EPOCH || (uint32_t)t >= RTC_CAL_END) return false;
+  if ((uint32_t)t - Year_Start >= Year_End - Year_Start)       // Other year
+     {
+     tmElements_t tm;
+     RTC_Break_Time(t, tm);
+     uint8_t Y    = tm.Year - 30;
+     Year_Start   = RTC_CAL_EPOCH + RTC_Cal_Days(Y, 1, 1) * RTC_CAL_DAY;
+     Year_End     = Year_Start + (365 + ((Y & 3) == 0)) * RTC_CAL_DAY;
+     Summer_Start = RTC_Cal_Last_Sunday(Y, 3, 31)  + 2 * 3600UL;
+     Summer_End   = RTC_Cal_Last_Sunday(Y, 10, 31) + 2 * 3600UL;
+     }
+  return (uint32_t)t >= Summer_Start && (uint32_t)t < Summer_End;
+}
+
+#endif // __RTC_CALENDAR__
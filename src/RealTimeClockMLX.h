@@ -15,6 +15,16 @@
  Und die folgende Zeile deaktiviert werden:
    #define RTC_DEBUG
 
+ Genaues Stellen mit dem PC
+ --------------------------
+ Mit dem Python Programm "extras/RTC_Sync.py" wird die Uhr auf besser als 100 ms genau gestellt:
+   python RTC_Sync.py COM3
+ Das Programm fragt die Zeit mehrfach mit dem Befehl "S?" ab und misst dabei die Laufzeit.
+ Anschlieend wird die Zeit mit "S=Sekunden.Millisekunden" (Sekunden seit 1970 in Winterzeit)
+ gesendet. Die bertragungszeit wird dabei bercksichtigt. Die RTC wird zur nchsten vollen
+ Sekunde geschrieben. Das funktioniert direkt nach dem Hochladen und auch spter.
+ Mit "python RTC_Sync.py COM3 --check" wird nur die Abweichung angezeigt.
+
 
  Ausgabe der Zeit
  ----------------
@@ -27,6 +37,40 @@
  Beispiel:
    EX.RT_Clock(#InCh, RTC_5MIN_OFFS , 0, MinOffs0, MinOffs4)
 
+ Wortuhr
+ -------
+ Mit RTC_WORDCLOCK werden alle Wrter einer Wortuhr mit einer Zeile angesteuert (Statt RTC_5MIN,
+ RTC_5MIN_OFFS, RTC_HOUR_WC1 und RTC_HOUR_WC2). Im Opt_Par wird die Variante angegeben:
+   "DE"          fnf nach, viertel nach, zwanzig nach, fnf vor halb, halb, ..., viertel vor  (Standard)
+   "DE_VIERTEL"  viertel, zehn vor halb, halb, zehn nach halb, dreiviertel
+   "EN"          five past, quarter past, half past, twenty five to, quarter to
+ Beispiel:
+   EX.RT_Clock(#InCh, RTC_WORDCLOCK, "DE_VIERTEL", Es, Punkt4)
+ Reihenfolge der Variablen:
+   DE: ES IST FNF ZEHN ZWANZIG DREI(viertel) VIERTEL VOR NACH HALB EIN S ZWEI DREI VIER FNF SECHS
+       SIEBEN ACHT NEUN ZEHN ELF ZWLF UHR Punkt1 Punkt2 Punkt3 Punkt4
+   EN: IT IS FIVE TEN QUARTER TWENTY HALF PAST TO ONE TWO THREE FOUR FIVE SIX SEVEN EIGHT NINE TEN
+       ELEVEN TWELVE OCLOCK Dot1 Dot2 Dot3 Dot4
+ Die Punkte zeigen die Minuten zwischen den 5 Minuten Schritten an. Wenn sie nicht bentigt werden,
+ dann knnen die letzten Variablen weggelassen werden.
+ Die Wrter fr alle Minuten sind in einer Tabelle im Flash gespeichert welche vom Compiler berechnet wird.
+ Die Tabelle der verwendeten Variante muss mit "#define RTC_WORDCLOCK_DE" (RTC_WORDCLOCK_DE_VIERTEL,
+ RTC_WORDCLOCK_EN) in der Excel Tabelle aktiviert werden. Jede Variante belegt 576 Byte im Flash.
+ Ohne diese Zeile bleiben die Ausgnge aus und beim Start wird eine Meldung ausgegeben.
+ Die Variablen werden nur einmal pro Minute gesetzt.
+
+ Helligkeit abhngig von der Uhrzeit
+ -----------------------------------
+ RTC_BRIGHT gibt eine Helligkeitsstufe aus, die von der Uhrzeit abhngt (Z.B. nachts dunkler).
+ Die Kurve wird im Opt_Par mit Sttzpunkten "hh:mm=Stufe" angegeben. Dazwischen wird die Stufe
+ linear interpoliert. Nach dem letzten Punkt geht die Kurve ber Mitternacht zum ersten Punkt.
+ Beispiel:
+   EX.RT_Clock(#InCh, RTC_BRIGHT, "6:00=1 7:30=7 21:00=7 23:00=1", Hell0, Hell2)
+ Die Stufe wird binr ausgegeben (3 Variablen = 0..7). Mit RTC_SINGLE wird nur die Variable der Stufe
+ gesetzt, mit RTC_BAR werden die ersten n Variablen gesetzt (Balken).
+ Die Kurve wird beim Start in eine Tabelle mit einem Eintrag alle RTC_BRIGHT_STEP (15) Minuten umgerechnet.
+ Die Stufe wird einmal pro Minute berechnet und nur bei einer nderung ausgegeben.
+
  Ausgabe der Temperatur
  ----------------------
  Die Bibliothek kann die interne temperatur der RTC ausgeben. EIgentlich ist diese recht genau. Dummerweise
@@ -46,9 +90,98 @@
 
  Mit 0.0. deffiniert man ereignisse die jeden Tag auftreten. Das kann z.B. der Text "Moba LED LIB" sein.
 
+ Bewegliche Feiertage werden mit EASTER+n, EASTER-n (Tage nach/vor Ostersonntag) und ADVENT1..ADVENT4
+ angegeben. Das Datum wird einmal im Jahr (beim Start und an Neujahr) berechnet.
+ Beispiel:
+   EX.RT_Clock(#InCh, RTC_DAYOFYEAR, "EASTER-2 EASTER EASTER+39 EASTER+49 ADVENT1", Karfreitag, Advent)
+
  Zum Test knnen den Zeilen eine Taste zugewiesen werden.
  Mit jedem Tastendruck wird die nchste Variable aktiviert.
 
+ Die Daten aller RTC_DAYOFYEAR Zeilen werden in einer gemeinsamen Tabelle gespeichert. Sie knnen ber
+ die serielle Schnittstelle ohne neues Hochladen gendert werden (Var = Nummer der Ausgangsvariable):
+   E?              Tabelle anzeigen
+   E+24.07. 12     Neuen Eintrag fr die Variable 12 hinzufgen (E+0.0. 12 = tglich)
+   E-24.07. 12     Eintrag lschen
+   E!              Gespeicherte Tabelle lschen => Nach dem nchsten Neustart gelten wieder die Daten der Konfiguration
+ Es werden nur Variablen angenommen, die zu einer RTC_DAYOFYEAR Zeile gehren.
+ Die Tabelle wird im EEPROM (ESP32: NVS) gespeichert. Wenn die Daten in der Konfiguration gendert werden,
+ dann wird die gespeicherte Tabelle ignoriert. Die Tabelle kann RTC_MAX_EVENTS Eintrge aufnehmen
+ (ESP32: 32, Nano: 16).
+
+
+ Sonnenaufgang / Sonnenuntergang
+ -------------------------------
+ Die Funktion RTC_SUN berechnet aus der Position (Breite und Lnge in Grad im Opt_Par) die Zeiten
+ fr die brgerliche Dmmerung, den Sonnenaufgang und den Sonnenuntergang. Damit kann die Beleuchtung
+ der Anlage im Sommer spter eingeschaltet werden als im Winter.
+ Beispiel:
+   EX.RT_Clock(#InCh, RTC_SUN | RTC_SINGLE, "52.52 13.40", Nacht, Abend)
+ Die Variablen sind: Nacht, Morgendmmerung, Tag, Abenddmmerung. Ohne RTC_SINGLE werden zwei Variablen
+ binr angesteuert. Ohne Opt_Par wird RTC_SUN_LAT/RTC_SUN_LON verwendet (Mitte von Deutschland).
+ Die Zeiten werden nur einmal am Tag berechnet und auf der seriellen Schnittstelle ausgegeben.
+ Da die Uhr in MEZ luft, ist die Funktion nur fr Positionen in Europa sinnvoll.
+ Nrdlich von 65 Breite weichen die berechneten Zeiten um etwa 5 bis 15 Minuten ab, weil die Sonne dort
+ sehr flach auf- und untergeht.
+
+
+ Stellen der Uhr per Taster
+ --------------------------
+ Mit den Funktionen RTC_INC_5MIN und RTC_DEC_5MIN kann die Uhr ber Taster gestellt werden.
+ Beispiel:
+   EX.RT_Clock(#InCh, RTC_INC_5MIN, 0, 0, 0)
+ Ein kurzer Tastendruck verstellt die Zeit um +5 Minuten (RTC_DEC_5MIN: -5 Minuten), die Sekunden werden auf 0 gesetzt.
+ Bei einem langen Tastendruck wird die Zeit rckwrts verstellt. Solange die Taste gehalten wird, wird
+ alle RTC_KEY_REPEAT ms weiter verstellt.
+ Die Zeit wird sofort angezeigt, aber erst RTC_ADJUST_WRITE_DELAY nach dem letzten Tastendruck einmal
+ in die RTC geschrieben. Dabei wird das komplette Datum geschrieben damit Schaltjahre stimmen.
+
+
+ Fehlersuche
+ -----------
+ Mit "#define RTC_TRACE_SIZE 32" (Zweierpotenz) in der Excel Tabelle wird ein Ringpuffer aktiviert in dem
+ jede nderung einer Variablen durch diese Erweiterung mit Zeit, Variable, Wert und Zeile (DstVar1, Typ)
+ protokolliert wird. nderungen von ActiveNr werden ebenfalls aufgezeichnet.
+ Der Puffer wird mit dem seriellen Befehl "T" ausgegeben ("T!" lscht ihn).
+ Die Aufzeichnung kostet nur wenige Takte und kann darum auch im normalen Betrieb aktiv bleiben.
+
+
+ Alle Meldungen (auch DEBUG_REALTIMECLOCK_TIME) werden ber einen Ringpuffer (RTC_LOG_SIZE) ausgegeben.
+ Dadurch wird die Hauptschleife nicht blockiert wenn der Sendepuffer der seriellen Schnittstelle voll ist.
+ Wenn der Ringpuffer voll ist, dann wird die Meldung verworfen. Mit RTC_LOG_RATE_TIME, RTC_LOG_RATE_DIAG
+ und RTC_LOG_RATE_ERR kann die Anzahl der Meldungen pro Kategorie begrenzt werden.
+ Der Befehl "L" zeigt die Anzahl der verworfenen Meldungen an.
+
+ Wenn die RTC nicht gelesen werden kann (Kabel, fehlende RTC, ungltige Daten, leere Batterie), dann luft
+ die Uhr ohne die RTC weiter. Der nchste Versuch erfolgt nach 1, 2, 4, ... Sekunden (max. RTC_SYNC_INTERVAL).
+ Der Befehl "H" zeigt die Anzahl der Fehler, den letzten Fehlercode und die Zeit der letzten erfolgreichen
+ Synchronisation an.
+
+
+ Warmstart
+ ---------
+ Nach einem Neustart durch den Watchdog oder die Software (Auch der tgliche Neustart um RTC_RESTART_HOUR)
+ werden die Uhrzeit und die Zeiten der RTC_DAYOFYEAR Zeilen aus einem RAM Bereich bernommen, der beim
+ Start nicht gelscht wird. Die Prfung der Compile Zeit und das erste Lesen der RTC entfallen.
+ Die Uhr wird anschlieend im Hintergrund mit der RTC synchronisiert. Die Abfrage des Temperatur
+ Sensors beginnt erst nach dieser Synchronisation. Eine mit den Tasten verstellte Zeit, die noch nicht in
+ die RTC geschrieben wurde, geht dabei nicht verloren.
+ Dadurch zeigen die LEDs direkt nach dem Neustart wieder den richtigen Zustand an.
+ Nach dem Einschalten oder einem neuen Hochladen erfolgt immer ein normaler Start.
+ RTC_WARM_INSTANCES legt fest, wie viele RTC_DAYOFYEAR Zeilen gesichert werden (ESP32: 4, Nano: 1).
+
+
+ I2C Bus
+ -------
+ Die RTC wird mit dem Standard Takt von 100 kHz angesprochen. Wenn alle I2C Gerte am gleichen Bus
+ den Fast Mode untersttzen, kann mit "#define RTC_I2C_CLOCK 400000UL" in der Excel Tabelle der
+ vierfache Takt eingestellt werden. Der Takt gilt fr alle Gerte an diesem Bus.
+ Beim ESP32 kann die RTC an den zweiten I2C Controller angeschlossen werden. Dann stren sich die RTC
+ und andere I2C Gerte nicht gegenseitig:
+   #define RTC_I2C_BUS  Wire1
+   #define RTC_I2C_SDA  32
+   #define RTC_I2C_SCL  33
+
 
  Achtung:
  ~~~~~~~~
@@ -68,6 +201,24 @@
             - Improved the RTC_DAYOFYEAR function
  09.08.23:  - Restarting the CPU every night at 3:00:00 to reset the millis() counter to prevent an overflow some where in the lib
  11.08.23:  - Cleared ExtActiv to prevent showing the birthdays at the wrong day if the buttons has been pressed before
+ 19.10.26:  - Setting the time with buttons (RTC_INC_5MIN, RTC_DEC_5MIN). The RTC is written once after the last key press
+            - RTC_DAYOFYEAR uses a day of year bit index which is checked once per day. The dates could be changed
+              with the serial interface and are stored in the EEPROM/NVS
+            - Optional trace buffer for the output variables (RTC_TRACE_SIZE)
+            - Non blocking, rate limited log for the serial messages
+            - now_ms(): Millisecond wall clock which is locked to the seconds rollover of the RTC
+            - RTC_SUN: Night, dawn, day and dusk calculated once per day from the position
+            - Movable holidays (EASTER+n, ADVENTn) for RTC_DAYOFYEAR
+            - Validated RTC reads, exponential backoff if the RTC is failing, health counters (Serial command "H")
+            - Precise setting of the time with the PC (Serial command "S", extras/RTC_Sync.py)
+            - The seconds of the compile time have been wrong (__TIME__[8] instead of [7])
+            - Division free calendar functions (RTC_Calendar.h) instead of makeTime(), breakTime()
+              and summertime_RAMsave()
+            - RTC_WORDCLOCK: All words of a word clock with one instance (German and English layouts)
+            - RTC_BRIGHT: Brightness level from a time of day curve (Night dimming)
+            - Warm start after a watchdog/software reset: The time and the RTC_DAYOFYEAR timers are
+              restored from a no-init RAM block
+            - Selectable I2C bus (RTC_I2C_BUS, RTC_I2C_SDA, RTC_I2C_SCL) and I2C clock (RTC_I2C_CLOCK, fast mode optional)
 
  ToDo:
  ~~~~~
@@ -82,12 +233,6 @@
  - Beim ersten Start nach dem complie wird die falsche Zeit mit dem Worten angezeigt.
    Die Zeit auf der seriellen Schnittstelle stimmt. Das knnte daran liegen, dass die Zeit
    nicht aus der RTC gelesen wird.
- - Stellen per Taster
-   Die aktuelle Zeit & Datum sollte regelmig gespeichert werden sonst stimmt das Datum/Schaltjahr
-   nicht mehr wenn man nur die Zeit verstellt.
-   - Taster
-     +/- 5 Minuten, Sekunde wird auf 0 gesetzt
-     Lang = Rckwrts
  - RTC_MOBA_TIME
 
 
@@ -154,12 +299,16 @@
 #define RTC_OFF         11     // Disable all outputs (0 or Max+1)
 #define RTC_TEMP_WC     12     // Temperatur for the Word Clock 1:18C .. 12:29C
 //#define RTC_MOBA_TIME 13     // Show the Moba Time
-//#define RTC_INC_5MIN  14     // Increment the time by 5 minutes and set the seconds to 0
-//#define RTC_DEC_5MIN  15     // Decrement  "                         "
+#define RTC_INC_5MIN    14     // Increment the time by 5 minutes and set the seconds to 0 (Long press = backwards)
+#define RTC_DEC_5MIN    15     // Decrement  "                         "
+#define RTC_SUN         16     // Night (0), civil dawn (1), day (2), civil dusk (3) calculated from the position in Opt_Par
+#define RTC_WORDCLOCK   17     // All words of a word clock. Layout in Opt_Par: "DE" (Default), "DE_VIERTEL", "EN"
+#define RTC_BRIGHT      18     // Brightness level from a time of day curve in Opt_Par: "hh:mm=Level hh:mm=Level ..."
 
 // Flags
-#define _RTC_FIRST_FLAG 16
+#define _RTC_FIRST_FLAG 32
 #define RTC_SINGLE    (_RTC_FIRST_FLAG<< 0 )    // Set single output variables instead of coding the variables binary
+#define RTC_BAR       (_RTC_FIRST_FLAG<< 1 )    // RTC_BRIGHT: Bar mode. Level n activates the first n variables
 
 #define _RTC_MODE_MASK  (_RTC_FIRST_FLAG-1)
 
@@ -206,6 +355,18 @@
 #define RTC_RESTART_MINUTE           0      // Minute for the restart
 #endif
 
+#ifndef RTC_KEY_LONG_PRESS
+#define RTC_KEY_LONG_PRESS           1 Sec  // Long press of the RTC_INC_5MIN/RTC_DEC_5MIN button => Adjust the time backwards
+#endif
+
+#ifndef RTC_KEY_REPEAT
+#define RTC_KEY_REPEAT             500      // [ms] Repeat period while the button is hold after a long press
+#endif
+
+#ifndef RTC_ADJUST_WRITE_DELAY
+#define RTC_ADJUST_WRITE_DELAY       5 Sec  // The adjusted time is written to the RTC once after the last key press
+#endif
+
 #ifndef RTC_MIN_TEMP
 #define RTC_MIN_TEMP                18      // Minimal temperatur for RTC_TEMP_WC
 #endif
@@ -295,12 +456,459 @@ static bool     Contr_Var_Def = false; // time display when a special message (B
 #undef sec // Problem with the MLL define
 
 #include <DS3232RTC_Include.h>   // https://github.com/JChristensen/DS3232RTC
+#include <RTC_Calendar.h>        // Division free calendar functions                                                19.10.26:
 #include <Streaming.h>           // https://github.com/janelia-arduino/Streaming
 #include <EEPROM.h>
 
 DS3232RTC myRTC;
 static bool Initialized = false;
 
+// I2C bus of the RTC. On the ESP32 the RTC could use the second I2C controller (Wire1) to be independent
+// from other I2C devices. The clock applies to all devices on this bus.                                     19.10.26:
+#ifndef RTC_I2C_BUS
+#define RTC_I2C_BUS                  Wire
+#endif
+#ifndef RTC_I2C_CLOCK
+#define RTC_I2C_CLOCK                100000UL  // Standard mode. Use 400000UL (fast mode) if all devices on the bus support it
+#endif
+#ifdef ESP32
+  #ifndef RTC_I2C_SDA
+  #define RTC_I2C_SDA                -1        // -1 = Default pin of the I2C controller
+  #endif
+  #ifndef RTC_I2C_SCL
+  #define RTC_I2C_SCL                -1
+  #endif
+#endif
+
+// Time adjustment with the buttons (RTC_INC_5MIN, RTC_DEC_5MIN)
+static bool     RTC_Write_Pending = false;   // The time has been adjusted but not written to the RTC
+static uint32_t RTC_Last_Adjust;             // millis() of the last adjustment
+
+//----------------- Asynchronous log -----------------------
+
+// The messages of this module are written to a ring buffer. In each pass only as many characters
+// are transferred to the serial interface as fit into the transmit buffer => The main loop is never
+// blocked by the serial output. If the ring buffer is full the message is dropped and counted.
+// Messages could be rate limited per category. The counters are printed with the serial command "L".
+
+#ifndef RTC_LOG_SIZE
+  #ifdef ESP32
+    #define RTC_LOG_SIZE           512      // Size of the log ring buffer [byte]
+  #else
+    #define RTC_LOG_SIZE           128
+  #endif
+#endif
+
+#define RTC_LOG_TIME    0                   // Time printed every second with DEBUG_REALTIMECLOCK_TIME
+#define RTC_LOG_DIAG    1                   // Diagnostic messages
+#define RTC_LOG_ERR     2                   // Errors which could occur in every pass
+#define RTC_LOG_CATS    3
+
+#ifndef RTC_LOG_RATE_TIME
+#define RTC_LOG_RATE_TIME            0      // Minimal period between two messages of the category [ms] (0 = No limit)
+#endif
+
+#ifndef RTC_LOG_RATE_DIAG
+#define RTC_LOG_RATE_DIAG            0
+#endif
+
+#ifndef RTC_LOG_RATE_ERR
+#define RTC_LOG_RATE_ERR            10 Sec
+#endif
+
+//****************************
+class RTC_Log_C : public Print
+//****************************
+{
+  private:
+    char        Buf[RTC_LOG_SIZE];
+    uint16_t    Head;         // Next write position
+    uint16_t    Tail;         // Next character which is sent
+    uint16_t    Msg_Start;    // Start of the actual message. The characters before are complete messages which could be sent
+    bool        Dropping;     // The actual message is dropped because the buffer is full
+    uint32_t    Last[RTC_LOG_CATS];
+    uint16_t    Dropped;
+    uint16_t    Limited;
+  public:
+    bool        Blocking;     // Wait instead of dropping messages (Used in RTC_setup() to get all start messages)
+
+    //----------------------------------
+    private:uint32_t Period(uint8_t Cat)
+    //----------------------------------
+    {
+      switch (Cat)
+        {
+        case RTC_LOG_TIME: return RTC_LOG_RATE_TIME;
+        case RTC_LOG_DIAG: return RTC_LOG_RATE_DIAG;
+        default:           return RTC_LOG_RATE_ERR;
+        }
+    }
+
+    //----------------
+    public:RTC_Log_C()
+    //----------------
+    {
+      Head = Tail = Msg_Start = 0;
+      Dropping = Blocking = false;
+      Dropped  = Limited  = 0;
+      for (uint8_t Cat = 0; Cat < RTC_LOG_CATS; Cat++)
+          Last[Cat] = 0 - Period(Cat);      // => The first message is not limited
+    }
+
+    //----------------------------
+    public:size_t write(uint8_t c)
+    //----------------------------
+    // Called by Print/Streaming. A message ends with '\n'.
+    {
+      if (!Dropping)
+         {
+         uint16_t Next = Head + 1 < RTC_LOG_SIZE ? Head + 1 : 0;
+         if (Next == Tail && Blocking) Flush();
+         if (Next == Tail)                  // Buffer full => Drop the whole message
+              {
+              Head     = Msg_Start;
+              Dropping = true;
+              Dropped++;
+              }
+         else {
+              Buf[Head] = c;
+              Head      = Next;
+              }
+         }
+      if (c == '\n')
+         {
+         Msg_Start = Head;
+         Dropping  = false;
+         }
+      return 1;
+    }
+    using Print::write;
+
+    //----------------------------
+    public:bool Begin(uint8_t Cat)
+    //----------------------------
+    // Returns false if the message of the category should be skipped because of the rate limit
+    {
+      uint32_t mil = millis();
+      if (mil - Last[Cat] < Period(Cat)) // Overflow save calculation
+         {
+         Limited++;
+         return false;
+         }
+      Last[Cat] = mil;
+      return true;
+    }
+
+    //-----------------
+    public:void Drain()
+    //-----------------
+    // Non blocking: Called in each pass. Only complete messages are sent.
+    {
+      while (Tail != Msg_Start)
+        {
+        int Free = Serial.availableForWrite();
+        if (Free <= 0) return;
+        uint16_t n = (Msg_Start > Tail ? Msg_Start : RTC_LOG_SIZE) - Tail; // Continuous block
+        if (n > Free) n = Free;
+        Serial.write((const uint8_t*)&Buf[Tail], n);
+        Tail += n;
+        if (Tail >= RTC_LOG_SIZE) Tail = 0;
+        }
+    }
+
+    //-----------------
+    public:void Flush()
+    //-----------------
+    // Blocking: Sends also an incomplete message
+    {
+      Msg_Start = Head;
+      while (Tail != Msg_Start) Drain();
+      Serial.flush();
+    }
+
+    //----------------------
+    public:void Print_Stat()
+    //----------------------
+    {
+      Serial << F("Log: ") << Dropped << F(" dropped, ") << Limited << F(" rate limited, ")
+             << (Head + RTC_LOG_SIZE - Tail) % RTC_LOG_SIZE << '/' << RTC_LOG_SIZE << F(" byte used\n");
+    }
+};
+
+RTC_Log_C RTC_Log;
+
+//----------------- End asynchronous log -----------------------
+
+//----------------- Millisecond wall clock -----------------------
+
+// now() of the Time library has a resolution of one second. now_ms() returns the time with a
+// resolution of one millisecond. Its second boundary is locked to the seconds rollover of the RTC:
+// RTC_Sync_Loop() polls the seconds register of the RTC until it changes and uses this moment as
+// reference. This is repeated every RTC_SYNC_INTERVAL seconds.
+// To keep the I2C bus free for the rest of the loop the register is not read every millisecond for
+// a whole second: If the phase is unknown (Start, warm start, time set with "S") the rollover is
+// searched with a poll every RTC_SYNC_COARSE ms. Afterwards the register is only polled every
+// millisecond within +/- RTC_SYNC_WINDOW ms around the predicted rollover of now_ms().
+// If the RTC could not be read (Missing RTC, bad cable, invalid data, oscillator stopped) the software
+// clock continues without it and the next try is done after RTC_SYNC_RETRY, 2*RTC_SYNC_RETRY, 4*...
+// (Max. RTC_SYNC_INTERVAL). The error counters are printed with the serial command "H".
+// The flashing of RTC_TEMP_WC uses now_ms() => It's aligned to the change of the time. Delays and the
+// day of year timers use millis() because they must not be shifted if the time is set.
+
+#ifndef RTC_SYNC_INTERVAL
+#define RTC_SYNC_INTERVAL          300      // Period to synchronize the software clock with the RTC [s]
+#endif
+
+#ifndef RTC_SYNC_RETRY
+#define RTC_SYNC_RETRY               1 Sec  // First retry after a failed synchronization. Doubled with each further failure
+#endif
+
+#ifndef RTC_SYNC_WINDOW
+#define RTC_SYNC_WINDOW             20      // [ms] Polling window around the predicted seconds rollover (Drift of the clocks)
+#endif
+
+#define RTC_SYNC_COARSE             10      // [ms] Poll period while the rollover is searched
+
+#define RTC_ERR_NO_TICK 0x20                // The seconds of the RTC don't change (Error codes of the driver: DS3232RTC::DS32_ERR_...)
+
+#define RTC_SYNC_IDLE   0
+#define RTC_SYNC_LOCK   1                   // Searching the seconds rollover of the RTC (Poll every RTC_SYNC_COARSE ms)
+#define RTC_SYNC_FINE   2                   // Poll every ms within the window around the predicted rollover
+
+static time_t   RTC_Base_Sec   = 0;         // now_ms() = RTC_Base_Sec + (millis() - RTC_Base_Ms)
+static uint32_t RTC_Base_Ms    = 0;         // millis() at the second boundary RTC_Base_Sec
+static uint8_t  RTC_Sync_State = RTC_SYNC_IDLE;
+static uint32_t RTC_Sync_Start = 0;         // millis() of the last synchronization / start of the lock
+static uint32_t RTC_Sync_Poll  = 0;
+static uint8_t  RTC_Sync_Sec;               // Seconds register of the RTC at the start of the lock
+static bool     RTC_Sync_Locked = false;    // The second boundary of now_ms() matches the rollover of the RTC
+static bool     RTC_Sync_Armed;             // RTC_SYNC_FINE: The window has started and RTC_Sync_Sec is valid
+static uint8_t  RTC_Sync_Win;               // RTC_SYNC_FINE: Half width of the window [ms]
+static uint32_t RTC_Sync_Wait  = RTC_SYNC_INTERVAL * 1000UL; // Time to the next synchronization [ms]
+
+// Health counters (Serial command "H")
+static uint16_t RTC_Fails      = 0;         // Number of failed accesses to the RTC
+static uint16_t RTC_Retries    = 0;         // Number of synchronizations started after a failure
+static uint8_t  RTC_Fail_Cnt   = 0;         // Consecutive failures (0 = RTC is working)
+static uint8_t  RTC_Last_Err   = 0;         // I2C status or DS3232RTC::DS32_ERR_... / RTC_ERR_...
+static time_t   RTC_Last_Good  = 0;         // Time of the last successful synchronization
+
+//---------------------------
+time_t now_ms(uint16_t &MSec)
+//---------------------------
+// Returns the time in seconds and the milliseconds since the second boundary
+{
+  uint32_t Elapsed = millis() - RTC_Base_Ms;
+  while (Elapsed >= 1000)                   // Normally executed once per second => No division
+    {
+    RTC_Base_Ms  += 1000;
+    RTC_Base_Sec ++;
+    Elapsed      -= 1000;
+    }
+  MSec = Elapsed;
+  return RTC_Base_Sec;
+}
+
+//---------------
+uint32_t now_ms()
+//---------------
+// Time in milliseconds for the timers. Overflow after 49 days => Use differences (int32_t)(a - b)
+{
+  uint16_t MSec;
+  time_t   t = now_ms(MSec);
+  return (uint32_t)t * 1000 + MSec;
+}
+
+//---------------------------------------
+void RTC_Set_Time(time_t t, uint32_t Mil)
+//---------------------------------------
+// Set the software clocks. t is the time at millis() == Mil which must be a second boundary.
+// If Mil is in the past the Time library is only exact to the second until RTC_loop() calls
+// setTime() again at the next second boundary.
+{
+  RTC_Base_Sec    = t;
+  RTC_Base_Ms     = Mil;
+  RTC_Sync_Locked = false;                  // Set again by RTC_Sync_Loop() if the phase is known
+  uint16_t MSec;
+  setTime(now_ms(MSec));
+}
+
+//---------------------------
+void RTC_Adjust(long Seconds)
+//---------------------------
+// Adjust the software clocks without changing the millisecond phase
+{
+  RTC_Base_Sec += Seconds;
+  adjustTime(Seconds);
+}
+
+//--------------------
+time_t RTC_Read_Time()
+//--------------------
+// Read the time from the RTC. Returns 0 if the I2C transfer failed, the data are invalid
+// or the oscillator has been stopped (Empty battery). The reason is stored in DS3232RTC::errCode.
+{
+  time_t  t = myRTC.get();                  // Checks the number of bytes and the BCD ranges
+  uint8_t Status;
+  if (!t || myRTC.readRTC(DS3232RTC::DS32_STATUS, &Status, 1)) return 0;
+  if (Status & _BV(DS3232RTC::DS32_OSF))
+     {
+     DS3232RTC::errCode = DS3232RTC::DS32_ERR_OSF;
+     return 0;
+     }
+  return t;
+}
+
+//-----------------------------
+void RTC_Sync_Fail(uint8_t Err)
+//-----------------------------
+// The software clock continues. The next synchronization is delayed exponentially.
+{
+  RTC_Fails++;
+  RTC_Last_Err   = Err;
+  if (RTC_Fail_Cnt < 255) RTC_Fail_Cnt++;
+  RTC_Sync_Wait  = RTC_Fail_Cnt < 16 ? (uint32_t)RTC_SYNC_RETRY << (RTC_Fail_Cnt - 1) : RTC_SYNC_INTERVAL * 1000UL;
+  if (RTC_Sync_Wait > RTC_SYNC_INTERVAL * 1000UL) RTC_Sync_Wait = RTC_SYNC_INTERVAL * 1000UL;
+  RTC_Sync_State = RTC_SYNC_IDLE;
+  RTC_Sync_Start = millis();
+  RTC_Sync_Locked = false;
+  if (RTC_Log.Begin(RTC_LOG_ERR)) RTC_Log << F("RTC Sync FAIL! Err ") << Err << F(" Retry in ") << RTC_Sync_Wait / 1000 << F(" s\n");
+}
+
+//------------------------
+void RTC_Sync_Start_Lock()
+//------------------------
+// Start searching the next seconds rollover of the RTC
+{
+  if (RTC_Fail_Cnt) RTC_Retries++;
+  RTC_Sync_Start = millis();
+  RTC_Sync_Poll  = RTC_Sync_Start;
+  RTC_Sync_State = RTC_SYNC_LOCK;
+  if (myRTC.readRTC(DS3232RTC::DS32_SECONDS, &RTC_Sync_Sec, 1)) RTC_Sync_Fail(DS3232RTC::errCode);
+}
+
+//-----------------------------------
+void RTC_Sync_Start_Fine(uint8_t Win)
+//-----------------------------------
+// Wait for the predicted seconds rollover of the RTC. No I2C transfer until the window starts.
+{
+  RTC_Sync_Start = millis();
+  RTC_Sync_Win   = Win;
+  RTC_Sync_Armed = false;
+  RTC_Sync_State = RTC_SYNC_FINE;
+}
+
+//----------------------------------------
+void RTC_Sync_Done(time_t t, uint32_t Mil)
+//----------------------------------------
+// The exact seconds rollover of the RTC has been found
+{
+  if (!RTC_Write_Pending) RTC_Set_Time(t, Mil);
+  RTC_Sync_Locked = true;
+  if (RTC_Fail_Cnt) RTC_Log << F("RTC Sync OK after ") << RTC_Fail_Cnt << F(" failures\n");
+  RTC_Fail_Cnt   = 0;
+  RTC_Last_Good  = t;
+  RTC_Sync_Wait  = RTC_SYNC_INTERVAL * 1000UL;
+  RTC_Sync_State = RTC_SYNC_IDLE;
+  RTC_Sync_Start = Mil;
+}
+
+//------------------
+void RTC_Sync_Loop()
+//------------------
+// Synchronize the software clocks with the RTC at the seconds rollover of the RTC
+{
+  uint32_t mil = millis();
+  switch (RTC_Sync_State)
+    {
+    case RTC_SYNC_IDLE: if (mil - RTC_Sync_Start < RTC_Sync_Wait) return; // Overflow save calculation
+                        if (RTC_Write_Pending) return;                  // The adjusted time must not be overwritten
+                        if (RTC_Sync_Locked && !RTC_Fail_Cnt)
+                             RTC_Sync_Start_Fine(RTC_SYNC_WINDOW);      // Only the drift since the last synchronization
+                        else RTC_Sync_Start_Lock();
+                        break;
+    case RTC_SYNC_LOCK: {
+                        if (mil - RTC_Sync_Poll < RTC_SYNC_COARSE) return; // Overflow save calculation
+                        uint32_t Gap = mil - RTC_Sync_Poll;
+                        RTC_Sync_Poll = mil;
+                        uint8_t Seconds;
+                        if (myRTC.readRTC(DS3232RTC::DS32_SECONDS, &Seconds, 1)) { RTC_Sync_Fail(DS3232RTC::errCode); return; } // Stop polling at the first error
+                        if (Seconds == RTC_Sync_Sec)
+                           {
+                           if (mil - RTC_Sync_Start > 1100) RTC_Sync_Fail(RTC_ERR_NO_TICK); // No rollover => Try again later
+                           return;
+                           }
+                        // The rollover was between the last two polls => Preliminary phase at the latest possible
+                        // moment. The exact rollover is found at the next second => now_ms() never runs backwards.
+                        time_t t = RTC_Read_Time();
+                        if (!t) { RTC_Sync_Fail(DS3232RTC::errCode); return; }
+                        if (RTC_Write_Pending) { RTC_Sync_State = RTC_SYNC_IDLE; return; } // Restarted after the write
+                        RTC_Set_Time(t, mil);
+                        RTC_Sync_Start_Fine(Gap + 5 < RTC_SYNC_WINDOW ? RTC_SYNC_WINDOW : (Gap > 250 ? 255 : Gap + 5));
+                        }
+                        break;
+    case RTC_SYNC_FINE: {
+                        uint8_t Seconds;
+                        if (!RTC_Sync_Armed)
+                           {
+                           uint16_t MSec;
+                           now_ms(MSec);
+                           if (MSec < 1000 - RTC_Sync_Win) return; // Wait for the window
+                           if (myRTC.readRTC(DS3232RTC::DS32_SECONDS, &RTC_Sync_Sec, 1)) { RTC_Sync_Fail(DS3232RTC::errCode); return; }
+                           RTC_Sync_Armed = true;
+                           RTC_Sync_Poll  = mil;
+                           RTC_Sync_Start = mil;
+                           return;
+                           }
+                        if (mil == RTC_Sync_Poll) return; // The RTC is polled once per millisecond
+                        RTC_Sync_Poll = mil;
+                        if (myRTC.readRTC(DS3232RTC::DS32_SECONDS, &Seconds, 1)) { RTC_Sync_Fail(DS3232RTC::errCode); return; }
+                        if (Seconds == RTC_Sync_Sec)
+                           {
+                           if (mil - RTC_Sync_Start > 2U * RTC_Sync_Win)          // Not in the window
+                              {
+                              if (RTC_Sync_Locked)
+                                   {
+                                   RTC_Sync_Locked = false;
+                                   RTC_Sync_Start_Lock();                         // Search it again
+                                   }
+                              else RTC_Sync_Fail(RTC_ERR_NO_TICK);                // Also after the search => Try again later
+                              }
+                           return;
+                           }
+                        time_t t = RTC_Read_Time();
+                        if (!t) { RTC_Sync_Fail(DS3232RTC::errCode); return; }
+                        RTC_Sync_Done(t, mil);
+                        }
+                        break;
+    }
+}
+
+//-----------------------
+int16_t RTC_Temperature()
+//-----------------------
+// Temperature of the RTC [1/4 C]. The RTC measures it only every 64 s => It's read once per second
+// and not while the RTC is failing. Before an I2C transfer was made in every pass.
+{
+  static int16_t  Temp      = 0;
+  static uint32_t Last_Read = 0;
+  static bool     Valid     = false;
+  uint32_t mil = millis();
+  if ((!Valid || mil - Last_Read >= 1000) && RTC_Fail_Cnt == 0) // Overflow save calculation
+     {
+     Last_Read = mil;
+     uint8_t b[2];
+     if (myRTC.readRTC(DS3232RTC::DS32_TEMP_MSB, b, 2) == 0)
+        {
+        Temp  = (int16_t)((b[0] << 8) | b[1]) / 64;
+        Valid = true;
+        }
+     }
+  return Temp;
+}
+
+//----------------- End millisecond wall clock -----------------------
+
 // *** One wire temperature sensor DS18B20 ***
 
 #ifndef USE_RTC_TEMP_SENS      // By default the One Wire temperatur sensor is used because the internal sensor
@@ -318,67 +926,54 @@ static bool Initialized = false;
   DallasTemperature sensors(&OneWireBus);
 #endif
 
-//---------------------------------------------------------------------------------
-boolean summertime_RAMsave(int year, byte month, byte day, byte hour, byte tzHours)
-//---------------------------------------------------------------------------------
-// European Daylight Savings Time calculation by "jurs" for German Arduino Forum
-// input parameters: "normal time" for year, month, day, hour and tzHours (0=UTC, 1=MEZ)
-// return value: returns true during Daylight Saving Time, false otherwise
-// https://forum.arduino.cc/t/sommerzeitumstellung/151105/13
-{
-  if (month<3 || month>10) return false; // keine Sommerzeit in Jan, Feb, Nov, Dez
-  if (month>3 && month<10) return true;  // Sommerzeit in Apr, Mai, Jun, Jul, Aug, Sep
-  if ((month==3  && (hour + 24 * day)>=(1 + tzHours + 24*(31 - (5 * year /4 + 4) % 7))) ||
-      (month==10 && (hour + 24 * day)< (1 + tzHours + 24*(31 - (5 * year /4 + 1) % 7))))
-    return true;
-  else
-    return false;
-}
-
-//--------------------------------
-void printI00(int val, char delim)
-//--------------------------------
+//------------------------------------------------------
+void printI00(int val, char delim, Print &Out = RTC_Log)
+//------------------------------------------------------
 // Print an integer in "00" format (with leading zero),
-// followed by a delimiter character to Serial.
+// followed by a delimiter character to Out (Default: RTC_Log).
 // Input value assumed to be between 0 and 99.
 {
-    if (val < 10) Serial << '0';
-    Serial << _DEC(val);
-    if (delim > 0) Serial << delim;
+    if (val < 10) Out << '0';
+    Out << _DEC(val);
+    if (delim > 0) Out << delim;
     return;
 }
 
-//----------------------
-void printTime(time_t t)
-//----------------------
-// print time to Serial
+//--------------------------------------------
+void printTime(time_t t, Print &Out = RTC_Log)
+//--------------------------------------------
+// print time to Out
 {
-    printI00(hour(t), ':');
-    printI00(minute(t), ':');
-    printI00(second(t), ' ');
+    tmElements_t tm;
+    RTC_Break_Time(t, tm);                                                                                    // 19.10.26:
+    printI00(tm.Hour, ':', Out);
+    printI00(tm.Minute, ':', Out);
+    printI00(tm.Second, ' ', Out);
 }
 
-//----------------------
-void printDate(time_t t)
-//----------------------
-// print date to Serial
+//--------------------------------------------
+void printDate(time_t t, Print &Out = RTC_Log)
+//--------------------------------------------
+// print date to Out
 {
-    printI00(day(t), 0);
-    Serial << monthShortStr(month(t)) << _DEC(year(t));
+    tmElements_t tm;
+    RTC_Break_Time(t, tm);                                                                                    // 19.10.26:
+    printI00(tm.Day, 0, Out);
+    Out << monthShortStr(tm.Month) << _DEC(tmYearToCalendar(tm.Year));
 }
 
-//--------------------------
-void printDateTime(time_t t)
-//--------------------------
-// print date and time to Serial
+//------------------------------------------------
+void printDateTime(time_t t, Print &Out = RTC_Log)
+//------------------------------------------------
+// print date and time to Out
 {
-    boolean SummerTime = summertime_RAMsave(year(t), month(t), day(t), hour(t), 1);                           // 16.04.23:
+    boolean SummerTime = RTC_Summer_Time(t);                                                                  // 19.10.26: Old: summertime_RAMsave()
     if (SummerTime) t += 3600;
-    Serial.print(SummerTime?"SZ ":"WZ ");
+    Out.print(SummerTime?"SZ ":"WZ ");
 
-    printDate(t);
-    Serial << ' ';
-    printTime(t);
+    printDate(t, Out);
+    Out << ' ';
+    printTime(t, Out);
 }
 
 /*
@@ -418,7 +1013,7 @@ void Parse_DateTime_Str(char *Txt, int16_t SecOffset = -99)
   tmElements_t tm;
   int y = atoi(strtok(Txt, ","));
   if (y >= 100 && y < 1000)
-       Serial << F("Error: Year must be two digits or four digits!") << endl;
+       RTC_Log << F("Error: Year must be two digits or four digits!") << endl;
   else {
        if (y >= 1000)
            tm.Year = CalendarYrToTm(y);
@@ -432,12 +1027,12 @@ void Parse_DateTime_Str(char *Txt, int16_t SecOffset = -99)
        if (!Err) tm.Minute = atoi_strtok_with_check(Err);
        if (!Err) tm.Second = atoi_strtok_with_check(Err);
        if (Err) {
-                Serial << F("Wrong date/time entered '") << Txt << F("'\n") <<
-                          F("Syntax:  yy,mm,dd,hh,mm,ss\n"
-                            "Example: 23,08,06,22,59,00");
+                RTC_Log << F("Wrong date/time entered '") << Txt << F("'\n") <<
+                           F("Syntax:  yy,mm,dd,hh,mm,ss\n"
+                             "Example: 23,08,06,22,59,00\n");
                 return ;
                 }
-       t = makeTime(tm);
+       t = RTC_Make_Time(tm);
 
 //       myRTC.setAlarm(DS3232RTC::ALM1_MATCH_DATE, tm.Second, tm.Minute, tm.Hour, tm.Day);
 //       DS3232RTC::ALARM_TYPES_t alarmType = DS3232RTC::ALM1_MATCH_DATE;
@@ -463,7 +1058,7 @@ void Parse_DateTime_Str(char *Txt, int16_t SecOffset = -99)
               alarmType = DS3232RTC::ALM2_MATCH_DATE;
               myRTC.getAlarm(alarmType, Month, YearHi, YearLo);
               Year100 = YearHi * 16 + YearLo;
-              Serial << F("getAlarm:") << Hours << ':' << Minutes << ':' << Seconds << F(" Day:") << Day << '.' << Month << '.' << Year100 << endl;
+              RTC_Log << F("getAlarm:") << Hours << ':' << Minutes << ':' << Seconds << F(" Day:") << Day << '.' << Month << '.' << Year100 << endl;
 
               if (Hours == hour(t) && Minutes == minute(t) && Seconds == second(t) &&
                   Day == day(t) && Month == month(t) &&  Year100 == year(t)%100) return ; // time and date was set before
@@ -471,7 +1066,7 @@ void Parse_DateTime_Str(char *Txt, int16_t SecOffset = -99)
               myRTC.setAlarm(DS3232RTC::ALM1_MATCH_DATE, second(t), minute(t), hour(t), day(t));
               Year100 = year(t)%100;
               myRTC.setAlarm(DS3232RTC::ALM2_MATCH_DATE, month(t),  Year100/16, Year100 % 16);
-              Serial << F("Compile time written to the alarm registers\n");
+              RTC_Log << F("Compile time written to the alarm registers\n");
 
               //22:44:14.569 -> SZ 10May2023 22:43:46
 
@@ -487,13 +1082,14 @@ void Parse_DateTime_Str(char *Txt, int16_t SecOffset = -99)
               */
             #endif
             }
-       if (summertime_RAMsave(y, tm.Month, tm.Day, tm.Hour, 1))
+       if (RTC_Summer_Time(t))                                                                                 // 19.10.26: Old: summertime_RAMsave()
           t -= 3600;
-       myRTC.set(t);   // use the time_t value to ensure correct weekday is set
-       setTime(t);
-       Serial << F("RTC set to compile time: ");
+       uint8_t WrErr = myRTC.set(t);   // use the time_t value to ensure correct weekday is set
+       RTC_Set_Time(t, millis()); // Writing the seconds resets the divider chain of the RTC => The second starts now
+       if (WrErr) RTC_Log << F("RTC write FAIL! Err ") << WrErr << F(" Software clock ");                        // 19.10.26:
+       RTC_Log << F("RTC set to compile time: ");
        printDateTime(t);
-       Serial << endl;
+       RTC_Log << endl;
        }
 }
 
@@ -531,7 +1127,7 @@ void CompileTime_to_DateTime()
     __DATE__[4]==' ' ? '0' : __DATE__[4],  // First day letter, replace space with digit
     __DATE__[5], ',',                      // Second day letter
 
-    __TIME__[0], __TIME__[1], ',', __TIME__[3], __TIME__[4], ',', __TIME__[6], __TIME__[8],  ',', // Time
+    __TIME__[0], __TIME__[1], ',', __TIME__[3], __TIME__[4], ',', __TIME__[6], __TIME__[7],  ',', // Time   19.10.26: Old: [8] = '\0'
     '\0'
     };
 
@@ -542,23 +1138,46 @@ void CompileTime_to_DateTime()
 }
 
 
+void RTC_Warm_Save(time_t t);  // Defined in the warm start section below
+bool RTC_Warm_Start();
+
 //--------------
 void RTC_setup()
 //--------------
 // Is called only once
 {
 //  Serial.begin(115200);
-  Serial << F("Compile date: " __DATE__ " " __TIME__ "\n" ); // Don't delete this. It's importand to check the programm version
-
-  myRTC.begin();
+  RTC_Log.Blocking = true;  // The start messages must not be dropped
+  RTC_Log << F("Compile date: " __DATE__ " " __TIME__ "\n" ); // Don't delete this. It's importand to check the programm version
+
+  #if defined(DS32_TWOWIRE)                                                                                   // 19.10.26:
+    #ifdef ESP32
+      myRTC.begin(RTC_I2C_BUS, RTC_I2C_SDA, RTC_I2C_SCL, RTC_I2C_CLOCK);                                    // 19.10.26: Old: myRTC.begin()
+    #else
+      myRTC.begin(RTC_I2C_BUS, RTC_I2C_CLOCK);                                                                // 19.10.26:
+    #endif
+  #else
+    myRTC.begin();                                                                                            // 19.10.26: TinyWireM or old Wire library without bus selection
+  #endif
 
-  // setSyncProvider() causes the Time library to synchronize with the
-  // external RTC by calling RTC.get() every five minutes by default.
-  setSyncProvider(myRTC.get);
-  Serial << F("RTC Sync");
-  if (timeStatus() != timeSet) Serial << F(" FAIL!");
-  Serial << endl;
-  CompileTime_to_DateTime();                                                                                  // 16.04.23:
+  if (RTC_Warm_Start())                                                                                       // 19.10.26:
+     RTC_Log << F("Warm start\n");  // The compile time has been checked at the cold start
+  else {
+       // The software clock is synchronized by RTC_Sync_Loop() at the seconds rollover of the RTC
+       // every RTC_SYNC_INTERVAL seconds. setSyncProvider() is not used because the Time library would
+       // synchronize at an arbitrary point in the second.                                                    // 19.10.26:
+       time_t t = RTC_Read_Time();
+       if (t)
+          {
+          RTC_Set_Time(t, millis());  // Preliminary until the first seconds rollover
+          RTC_Last_Good = t;
+          }
+       RTC_Log << F("RTC Sync");
+       if (!t) RTC_Log << F(" FAIL! Err ") << DS3232RTC::errCode;                                             // 19.10.26:
+       RTC_Log << endl;
+       CompileTime_to_DateTime();                                                                             // 16.04.23:
+       }
+  RTC_Sync_Start_Lock();                                                                                      // 19.10.26:
 
   #if 0 // The #defines could be changed in the excel table. Therefore they could be printed here
     Serial << F("#defines:\n");
@@ -581,8 +1200,196 @@ void RTC_setup()
     //                                    // even if the type is exact the same DALLAS 18B20 2034C4 +817AB
     //                                    // According to the data sheet the resolution could be convigured. But how?
   #endif
+  RTC_Log.Blocking = false;
+}
+
+
+//----------------- Output trace -----------------------
+
+// Optional ring buffer which records every change of a variable made by this extension
+// and the changes of ActiveNr. Recording costs only a few cycles => It could be used in
+// the final layout. The buffer is printed with the serial command "T" ("T!" clears it).
+
+#ifndef RTC_TRACE_SIZE
+#define RTC_TRACE_SIZE               0      // Number of entries in the trace buffer (Power of 2, 8 byte each). 0 = Disabled
+#endif
+
+#define RTC_TR_SET      0x00                // Variable changed by Set_Var()
+#define RTC_TR_ACTIVE   0x80                // ActiveNr changed (Var = new ActiveNr, 0xFF = NO_ACTIVE_NR)
+
+#if RTC_TRACE_SIZE > 0
+  #if (RTC_TRACE_SIZE & (RTC_TRACE_SIZE - 1)) != 0
+    #error "RTC_TRACE_SIZE must be a power of 2"
+  #endif
+
+  typedef struct
+      {
+      uint32_t Time;                        // millis()
+      uint8_t  Var;
+      uint8_t  Val;                         // Bit 7: RTC_TR_ACTIVE, Bit 0: New value
+      uint8_t  Src;                         // Clock_Type of the instance
+      uint8_t  Line;                        // DstVar1 of the instance => Identifies the line in the configuration
+      } RTC_Trace_T;
+
+  static RTC_Trace_T RTC_Trace[RTC_TRACE_SIZE];
+  static uint32_t    RTC_Trace_Cnt = 0;
+  static uint8_t     RTC_Trace_Shadow[256/8];  // Last value of each variable => Only changes are recorded
+
+  //------------------------------------------------------------------------------------------
+  inline void RTC_Trace_Add(uint8_t Kind, uint8_t Var, uint8_t Val, uint8_t Src, uint8_t Line)
+  //------------------------------------------------------------------------------------------
+  {
+    RTC_Trace_T &e = RTC_Trace[RTC_Trace_Cnt++ & (RTC_TRACE_SIZE - 1)];
+    e.Time = millis();
+    e.Var  = Var;
+    e.Val  = Kind | Val;
+    e.Src  = Src;
+    e.Line = Line;
+  }
+
+  //-------------------------------------------------------------------------
+  inline void RTC_Trace_Var(uint8_t Var, bool Val, uint8_t Src, uint8_t Line)
+  //-------------------------------------------------------------------------
+  {
+    uint8_t &b = RTC_Trace_Shadow[Var >> 3];
+    uint8_t  m = 1 << (Var & 7);
+    if (((b & m) != 0) == Val) return;
+    b ^= m;
+    RTC_Trace_Add(RTC_TR_SET, Var, Val, Src, Line);
+  }
+#endif
+
+//---------------------------
+void RTC_Trace_Cmd(char *Cmd)
+//---------------------------
+// T   Print the trace buffer (Oldest entry first, time relative to now)
+// T!  Clear the trace buffer
+{
+  #if RTC_TRACE_SIZE > 0
+    if (*Cmd == '!')
+       {
+       RTC_Trace_Cnt = 0;
+       Serial << F("Trace cleared\n");
+       return;
+       }
+    uint32_t mil   = millis();
+    uint32_t First = RTC_Trace_Cnt > RTC_TRACE_SIZE ? RTC_Trace_Cnt - RTC_TRACE_SIZE : 0;
+    Serial << F("Trace ") << RTC_Trace_Cnt - First << F(" of ") << RTC_Trace_Cnt << F(" entries at ");
+    printDateTime(now(), Serial);
+    Serial << endl;
+    for (uint32_t i = First; i < RTC_Trace_Cnt; i++)
+        {
+        const RTC_Trace_T &e = RTC_Trace[i & (RTC_TRACE_SIZE - 1)];
+        Serial << '-' << mil - e.Time << F(" ms  Line ") << e.Line << F(" Type ") << (e.Src & _RTC_MODE_MASK);
+        if (e.Val & RTC_TR_ACTIVE)
+             Serial << F("  ActiveNr ") << e.Var;
+        else {
+             Serial << F("  Var ") << e.Var << '=' << (e.Val & 1);
+             if (Contr_Var_Def && e.Var >= Contr_Var && e.Var < Contr_Var + CONTR_VAR_CNT) Serial << F(" (Contr_Var+") << e.Var - Contr_Var << ')';
+             }
+        Serial << endl;
+        }
+  #else
+    (void)Cmd;                              // Unused
+    Serial << F("Trace disabled (RTC_TRACE_SIZE)\n");
+  #endif
+}
+
+//----------------- End output trace -----------------------
+
+
+//---------------------
+void RTC_Health_Print()                                                                                       // 19.10.26:
+//---------------------
+// Serial command "H": Error counters of the RTC access
+// Err: 1..5 I2C status, 16 Wrong number of bytes, 17 Invalid data, 18 Oscillator stopped, 32 Seconds don't change
+{
+  Serial << F("RTC ") << (RTC_Fail_Cnt ? F("FAILING") : F("OK")) << F("  Fails: ") << RTC_Fails << F("  Retries: ") << RTC_Retries
+         << F("  Last Err: ") << RTC_Last_Err;
+  if (RTC_Fail_Cnt)
+     {
+     uint32_t Elapsed = millis() - RTC_Sync_Start;
+     Serial << F("  Next try in ") << (Elapsed < RTC_Sync_Wait ? (RTC_Sync_Wait - Elapsed) / 1000 : 0) << F(" s"); // 0 while the try is running
+     }
+  Serial << F("\nLast good sync: ");
+  if (RTC_Last_Good)
+       {
+       printDateTime(RTC_Last_Good, Serial);
+       Serial << F(" (") << (long)(now() - RTC_Last_Good) << F(" s ago)");
+       }
+  else Serial << F("never");
+  Serial << endl;
+}
+
+
+//-----------------------------------
+void RTC_Adjust_Time(int16_t Minutes)                                                                         // 19.10.26:
+//-----------------------------------
+// Adjust the time by the given number of minutes and set the seconds to 0.
+// Only the software clock is changed here. The RTC is written once in RTC_loop()
+// after the key sequence has settled to avoid an I2C write for each key press.
+// Until then RTC_Sync_Loop() doesn't load the old time from the RTC.
+{
+  #ifdef RTC_DEBUG
+    RTC_Minutes = (RTC_Minutes + 24 * 60 + Minutes) % (24 * 60);
+  #else
+    RTC_Adjust(Minutes * 60L - second(now())); // Keeps the millisecond phase
+    RTC_Write_Pending = true;
+    RTC_Last_Adjust   = millis();
+    RTC_Log << F("Time adjusted: ");
+    printDateTime(now());
+    RTC_Log << endl;
+  #endif
 }
 
+//------------------------------------------
+void RTC_Time_Cmd(char *Cmd, uint32_t RxMil)                                                                  // 19.10.26:
+//------------------------------------------
+// Synchronization with the PC (extras/RTC_Sync.py). RxMil is millis() at the reception of the command.
+//  S?           Answer "S=sec.ms" with the time of the software clock at the reception of the command
+//  S=sec.ms     Set the time. The time is valid at the reception of the first character.
+//               The RTC is written at the next second boundary.
+// sec = Seconds since 1.1.1970 in MEZ (Winter time) like the RTC
+// The PC measures the round trip time of "S?" and adds the half of it to the time sent with "S=".
+// The answer is written directly to Serial to avoid the delay of the log buffer. Before the log buffer
+// is flushed. Otherwise the answer could be inserted into a partly sent log line.
+// The time is taken at the reception => The delay of the flush doesn't change the answer. The PC uses
+// the answer with the shortest round trip time.
+{
+  RTC_Log.Flush();
+  switch (*Cmd)
+    {
+    case '?': {
+              uint16_t MSec;
+              uint32_t Seconds = now_ms(MSec);
+              int32_t  Elapsed = RxMil - RTC_Base_Ms;           // Negative if the second boundary was after the reception
+              while (Elapsed < 0) { Elapsed += 1000; Seconds--; }
+              MSec = Elapsed;
+              Serial << F("S=") << Seconds << '.' << (MSec < 100 ? "0" : "") << (MSec < 10 ? "0" : "") << MSec << endl;
+              }
+              return;
+    case '=': {
+              char    *p;
+              uint32_t Seconds = strtoul(Cmd+1, &p, 10);
+              uint16_t MSec    = 0;
+              if (*p == '.')
+                 for (uint8_t i = 0; i < 3; i++)
+                     {
+                     MSec *= 10;
+                     if (isdigit(p[1])) MSec += *++p - '0';     // Missing digits are 0 ("S=1700000000.5" = 500 ms)
+                     }
+              if (Seconds < 946684800UL) break;                 // Before 2000 => Wrong format
+              RTC_Set_Time(Seconds, RxMil - MSec);              // The second started MSec before the reception
+              RTC_Write_Pending = true;                         // The RTC and the Time library are set at the next second boundary
+              RTC_Last_Adjust   = millis() - RTC_ADJUST_WRITE_DELAY - 1;
+              Serial << F("S=OK\n");
+              }
+              return;
+    }
+  Serial << F("Error in time command\nSyntax:  S?  S=sec.ms\n");
+}
+
+void RTC_Event_Cmd(char *Cmd); // Defined in the day of year events section below
 
 //--------------
 void RTC_loop()
@@ -591,8 +1398,9 @@ void RTC_loop()
   static time_t tLast;
   #if !defined USE_RS232_OR_SPI_AS_INPUT &&  !defined RECEIVE_LED_COLOR_PER_RS232 // Problem with DCC
     // check for input to set the RTC, minimum length is 12, i.e. yy,m,d,h,m,s
-    if (Serial.available() >= 12 || (Serial.available() > 1 && Serial.peek() == '?'))
+    if (Serial.available() >= 12 || (Serial.available() > 1 && (Serial.peek() == '?' || isalpha(Serial.peek())))) // 19.10.26: Commands start with a letter
         {
+        uint32_t RxMil = millis();                                                                            // 19.10.26: Reception time for the "S" command
         char Buf[31], *p, *e, c;
         p = Buf;
         e = p + sizeof(Buf) - 1;
@@ -603,11 +1411,41 @@ void RTC_loop()
             delay(1); // To be able to receive futher characters
             }
         *p = '\0';
-        Serial << "Buf:'" << Buf << "'\n";
-        Parse_DateTime_Str(Buf);                                                                                // 16.04.23:
+        RTC_Log << "Buf:'" << Buf << "'\n";
+        if      (Buf[0] == 'E') RTC_Event_Cmd(Buf+1);                                                           // 19.10.26:
+        else if (Buf[0] == 'T') RTC_Trace_Cmd(Buf+1);
+        else if (Buf[0] == 'L') RTC_Log.Print_Stat();
+        else if (Buf[0] == 'H') RTC_Health_Print();
+        else if (Buf[0] == 'S') RTC_Time_Cmd(Buf+1, RxMil);
+        else                    Parse_DateTime_Str(Buf);                                                        // 16.04.23:
         }
   #endif
 
+  RTC_Sync_Loop();                                                                                            // 19.10.26:
+
+  static time_t Last_Sec;
+  uint16_t MSec;
+  time_t   tSec = now_ms(MSec);
+  if (tSec != Last_Sec)  // Directly after the second boundary => The RTC keeps the millisecond phase of now_ms()
+     {
+     Last_Sec = tSec;
+     RTC_Warm_Save(tSec);                                                                                     // 19.10.26:
+     uint32_t mil = millis();
+     if (RTC_Write_Pending && mil - RTC_Last_Adjust > RTC_ADJUST_WRITE_DELAY &&      // Overflow save calculation
+         (!RTC_Fail_Cnt || mil - RTC_Sync_Start >= RTC_Sync_Wait))                  // Use the backoff if the RTC is failing
+        {
+        setTime(tSec);                  // Align the Time library to the second boundary (RTC_Time_Cmd())
+        uint8_t Err = myRTC.set(tSec);  // The complete date is written to keep the weekday and leap years correct
+        if (Err) RTC_Sync_Fail(Err);
+        else {
+             RTC_Write_Pending = false;
+             RTC_Sync_Locked   = true;       // Writing the seconds restarts the second of the RTC at the boundary of now_ms()
+             RTC_Log << F("Adjusted time written to the RTC\n");
+             if (RTC_Fail_Cnt) RTC_Sync_Start_Lock();  // Check if the RTC is working again
+             }
+        }
+     }
+
   #ifdef DEBUG_REALTIMECLOCK_TIME // Debug: Print the time to the serial output
     if (Disable_Outputs == false)
        {
@@ -616,17 +1454,22 @@ void RTC_loop()
        if (t != tLast)
           {
           tLast = t;
-          printDateTime(t);
-          if (second(t) == 0) // Internal temperatur (Not accurate because of ESP32 heat up)
-              {
-              float c = myRTC.temperature() / 4.;
-              Serial << F("  ") << c << F(" C  ")
-              //Serial << c * 9. / 5. + 32. << F(" F");
-              }
-          Serial << endl;
+          if (RTC_Log.Begin(RTC_LOG_TIME))                                                                    // 19.10.26: Rate limited => Only the dropped messages are counted
+             {
+             printDateTime(t);
+             if (second(t) == 0) // Internal temperatur (Not accurate because of ESP32 heat up)
+                 {
+                 float c = RTC_Temperature() / 4.;
+                 RTC_Log << F("  ") << c << F(" C  ");
+                 //RTC_Log << c * 9. / 5. + 32. << F(" F");
+                 }
+             RTC_Log << endl;
+             }
           }
        }
   #endif
+
+  RTC_Log.Drain();                                                                                            // 19.10.26:
 }
 
 
@@ -664,6 +1507,980 @@ int ReadNr(const char* &p, char Del)
 
 #define MAXDATES 10
 
+//----------------- Day of year events -----------------------
+
+// The dates of all RTC_DAYOFYEAR lines are collected in one table which is shared by all instances.
+// A bit index with one bit per day of the year is used to check if there is an event at the actual day.
+// This check is done only once per day. The table could be changed with serial commands (see RTC_Event_Cmd())
+// and is stored in the EEPROM (ESP32: NVS).
+// Movable holidays ("EASTER+1", "ADVENT2") are converted to a date once per year (At the start and at new year).
+
+#ifndef RTC_MAX_EVENTS
+  #ifdef ESP32
+    #define RTC_MAX_EVENTS          32      // Maximal number of entries in the day of year table (All RTC_DAYOFYEAR lines)
+  #else
+    #define RTC_MAX_EVENTS          16      // Needs 5 bytes RAM per entry
+  #endif
+#endif
+
+#if defined(ESP32)
+  #include <Preferences.h>                  // The ESP32 stores the table in the NVS
+#endif
+
+#define RTC_RULE_DATE     0                 // Fixed date "dd.mm."
+#define RTC_RULE_EASTER   1                 // "EASTER+n" n days after easter sunday (Karfreitag = EASTER-2, Pfingsten = EASTER+49)
+#define RTC_RULE_ADVENT   2                 // "ADVENTn"  n-th sunday of advent (1..4)
+
+typedef struct
+    {
+    uint8_t Day;                            // 1..31, 0 = Daily event ("0.0.")
+    uint8_t Month;                          // 1..12
+    uint8_t Var;                            // Variable which is activated (DstVar1 + Nr of the RTC_DAYOFYEAR line)
+    uint8_t Rule;                           // RTC_RULE_DATE or movable holiday. Day and Month contain the date in the actual year
+    int8_t  Offs;                           // Days after easter / Number of the advent sunday
+    } RTC_Event_T;
+
+#define RTC_EVENTS_MAGIC  0xE2
+
+typedef struct
+    {
+    uint8_t     Magic;
+    uint8_t     Cnt;
+    uint16_t    Def;                        // Checksum of the table defined in the configuration
+    uint16_t    Chk;                        // Checksum of the members above and the entries
+    } RTC_Event_Hdr_T;                      // Stored in front of the entries
+
+typedef struct RTC_Event_Line_S
+    {
+    uint8_t                  Var1;          // DstVar1 of the RTC_DAYOFYEAR line
+    uint8_t                  Cnt;           // Number of variables of the line
+    struct RTC_Event_Line_S *Next;
+    } RTC_Event_Line_T;
+
+#ifndef RTC_EVENTS_EEPROM_ADDR              // Stored at the end of the EEPROM (Not used by the ESP32)
+#define RTC_EVENTS_EEPROM_ADDR (EEPROM.length() - sizeof(RTC_Event_Hdr_T) - RTC_MAX_EVENTS * sizeof(RTC_Event_T))
+#endif
+
+static RTC_Event_T RTC_Events[RTC_MAX_EVENTS];
+static RTC_Event_Line_T *RTC_Event_Lines = NULL; // Variables of all RTC_DAYOFYEAR lines => Check of the serial commands
+static uint8_t     RTC_Events_Cnt    = 0;
+static bool        RTC_Events_Loaded = false;
+static uint16_t    RTC_Events_Def;            // Checksum of the table defined in the configuration
+static uint8_t     RTC_Event_Days[(366+7)/8]; // Day of year index: One bit for each day with at least one event
+static uint16_t    RTC_Event_DayNr   = 0;     // Day index + 1 when the index was checked the last time (0 = Check again)
+static bool        RTC_Events_Today  = false; // There is at least one event at the actual day
+static uint8_t     RTC_Event_Gen     = 0;     // Incremented with each check => The instances recalculate their masks
+static uint16_t    RTC_Event_Year    = 0;     // Year for which the movable holidays have been calculated (0 = Unknown)
+
+// First day of each month in a leap year => The 29.2. has its own bit
+static const uint16_t RTC_Month_Start[12] PROGMEM = { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335 };
+
+//------------------------------------------------
+uint16_t RTC_Day_Index(uint8_t Day, uint8_t Month)
+//------------------------------------------------
+{
+  return pgm_read_word(&RTC_Month_Start[Month-1]) + Day - 1;
+}
+
+//---------------------------------------------
+bool RTC_Date_Valid(uint8_t Day, uint8_t Month)
+//---------------------------------------------
+// Check the date before RTC_Day_Index() is used. The 29.2. is allowed because the index contains it.
+// "0.0." is the daily event.
+{
+  if (Day == 0 && Month == 0) return true;
+  if (Day == 0 || Month == 0 || Month > 12) return false;
+  uint16_t Next = Month < 12 ? pgm_read_word(&RTC_Month_Start[Month]) : 366;
+  return Day <= Next - pgm_read_word(&RTC_Month_Start[Month-1]);
+}
+
+//---------------------------------------------------------------------
+uint16_t RTC_Checksum(const void *Data, uint16_t Len, uint16_t Sum = 0)
+//---------------------------------------------------------------------
+// Sum could be the result of a previous call => Checksum of several blocks
+{
+  const uint8_t *p = (const uint8_t*)Data;
+  Sum += Len;
+  while (Len--) Sum = Sum * 31 + *(p++);
+  return Sum;
+}
+
+//----------------------------------------
+bool RTC_Event_Daily(const RTC_Event_T &e)
+//----------------------------------------
+{
+  return e.Day == 0 && e.Rule == RTC_RULE_DATE;
+}
+
+//-------------------------------
+bool RTC_Leap_Year(uint16_t Year)
+//-------------------------------
+{
+  return (Year % 4 == 0 && Year % 100 != 0) || Year % 400 == 0;
+}
+
+//-----------------------------------------------------------------
+uint16_t RTC_Day_Of_Year(uint8_t Day, uint8_t Month, uint16_t Year)
+//-----------------------------------------------------------------
+// Day of the year starting with 0
+{
+  return RTC_Day_Index(Day, Month) - (Month > 2 && !RTC_Leap_Year(Year));
+}
+
+//--------------------------------------------
+uint16_t RTC_Easter_Day_Of_Year(uint16_t Year)
+//--------------------------------------------
+// Easter sunday (Gauss algorithm for the gregorian calendar)
+{
+  uint8_t  a = Year % 19;
+  uint8_t  b = Year / 100,  c = Year % 100;
+  uint8_t  d = b / 4,       e = b % 4;
+  uint8_t  f = (b + 8) / 25;
+  uint8_t  g = (b - f + 1) / 3;
+  uint8_t  h = (19 * a + b - d - g + 15) % 30;
+  uint8_t  i = c / 4,       k = c % 4;
+  uint8_t  l = (32 + 2 * e + 2 * i - h - k) % 7;
+  uint8_t  m = (a + 11 * h + 22 * l) / 451;
+  uint16_t n = h + l - 7 * m + 114;
+  return RTC_Day_Of_Year(n % 31 + 1, n / 31, Year);
+}
+
+//--------------------------------------------------------
+uint16_t RTC_Advent_Day_Of_Year(uint16_t Year, uint8_t Nr)
+//--------------------------------------------------------
+// Nr-th sunday of advent. The 4th advent is the last sunday before the 25.12.
+{
+  uint8_t WDay = (Year + Year / 4 - Year / 100 + Year / 400 + 4 + 24) % 7;   // Weekday of the 24.12. (0 = sunday, Sakamoto)
+  return RTC_Day_Of_Year(24 - WDay, 12, Year) - 7 * (4 - Nr);
+}
+
+//------------------------------------
+void RTC_Event_Resolve(RTC_Event_T &e)
+//------------------------------------
+// Calculate the date of a movable holiday for RTC_Event_Year
+{
+  if (e.Rule == RTC_RULE_DATE || RTC_Event_Year == 0) return;
+  bool    Leap = RTC_Leap_Year(RTC_Event_Year);
+  int16_t Doy;
+  if (e.Rule == RTC_RULE_EASTER)
+       Doy = RTC_Easter_Day_Of_Year(RTC_Event_Year) + e.Offs;
+  else Doy = RTC_Advent_Day_Of_Year(RTC_Event_Year, e.Offs);
+  if (Doy < 0 || Doy >= 365 + Leap) { e.Day = e.Month = 0; return; }  // Not in this year
+  uint16_t Ix = Doy + (!Leap && Doy >= 59); // The index always contains the 29.2. => Skip it in normal years
+  uint8_t Month = 12;
+  while (pgm_read_word(&RTC_Month_Start[Month-1]) > Ix) Month--;
+  e.Month = Month;
+  e.Day   = Ix - pgm_read_word(&RTC_Month_Start[Month-1]) + 1;
+}
+
+//-----------------------------------------
+int8_t RTC_Event_Find(const RTC_Event_T &e)
+//-----------------------------------------
+{
+  for (uint8_t i = 0; i < RTC_Events_Cnt; i++)
+      {
+      const RTC_Event_T &t = RTC_Events[i];
+      if (t.Var == e.Var && t.Rule == e.Rule &&
+          (e.Rule == RTC_RULE_DATE ? t.Day == e.Day && t.Month == e.Month : t.Offs == e.Offs)) return i;
+      }
+  return -1;
+}
+
+//--------------------------------------
+bool RTC_Event_Add(const RTC_Event_T &e)
+//--------------------------------------
+// Attention: Also called in the constructor => No serial output possible
+{
+  if (RTC_Event_Find(e) >= 0) return true;  // Already in the table
+  if (RTC_Events_Cnt >= RTC_MAX_EVENTS) return false;
+  RTC_Events[RTC_Events_Cnt] = e;
+  RTC_Event_Resolve(RTC_Events[RTC_Events_Cnt++]);
+  return true;
+}
+
+//-----------------------------------------
+bool RTC_Event_Remove(const RTC_Event_T &e)
+//-----------------------------------------
+{
+  int8_t i = RTC_Event_Find(e);
+  if (i < 0) return false;
+  RTC_Events_Cnt--;
+  memmove(&RTC_Events[i], &RTC_Events[i+1], (RTC_Events_Cnt - i) * sizeof(RTC_Event_T));
+  return true;
+}
+
+//------------------------------------------------
+bool RTC_Read_Date(const char* &p, RTC_Event_T &e)
+//------------------------------------------------
+// Read a date "dd.mm." or a movable holiday "EASTER+n", "EASTER-n", "ADVENTn"
+{
+  while (*p == ' ') p++;
+  e.Day  = e.Month = 0;
+  e.Rule = RTC_RULE_DATE;
+  e.Offs = 0;
+  if (strncasecmp_P(p, PSTR("EASTER"), 6) == 0)
+     {
+     p += 6;
+     e.Rule = RTC_RULE_EASTER;
+     if (*p != '+' && *p != '-') return true;
+     long Offs = strtol(p, (char**)&p, 10);   // Checked before it's stored in the int8_t                     19.10.26:
+     e.Offs = Offs;
+     return Offs >= INT8_MIN && Offs <= INT8_MAX;
+     }
+  if (strncasecmp_P(p, PSTR("ADVENT"), 6) == 0)
+     {
+     p += 6;
+     e.Rule = RTC_RULE_ADVENT;
+     long Nr = strtol(p, (char**)&p, 10);
+     e.Offs = Nr;
+     return Nr >= 1 && Nr <= 4;
+     }
+  e.Day   = ReadNr(p, '.');
+  e.Month = ReadNr(p, '.');
+  return RTC_Date_Valid(e.Day, e.Month);                                                                      // 19.10.26: Old: Day <= 31, Month <= 12
+}
+
+//----------------------------
+void RTC_Events_Update_Index()
+//----------------------------
+{
+  memset(RTC_Event_Days, 0, sizeof(RTC_Event_Days));
+  for (uint8_t i = 0; i < RTC_Events_Cnt; i++)
+      {
+      if (RTC_Events[i].Day == 0) continue; // Daily events (and holidays which are not calculated jet) are not stored in the index
+      uint16_t Ix = RTC_Day_Index(RTC_Events[i].Day, RTC_Events[i].Month);
+      RTC_Event_Days[Ix >> 3] |= 1 << (Ix & 7);
+      }
+  RTC_Event_DayNr = 0;                      // Check the actual day again
+}
+
+#if defined(ESP32)
+  static Preferences RTC_Prefs;
+#endif
+
+//---------------------------------------
+bool RTC_Events_Storage_Begin(bool Write)
+//---------------------------------------
+{
+  #if defined(ESP32)
+    return RTC_Prefs.begin("RT_Clock", !Write);
+  #else
+    (void)Write;                            // The EEPROM is always available
+    return true;
+  #endif
+}
+
+//---------------------------
+void RTC_Events_Storage_End()
+//---------------------------
+{
+  #if defined(ESP32)
+    RTC_Prefs.end();
+  #endif
+}
+
+//---------------------------------------------------------------------
+void RTC_Events_Storage(int8_t Nr, void *Data, uint8_t Len, bool Write)
+//---------------------------------------------------------------------
+// Read or write the header (Nr < 0) or the entry Nr of the stored table.
+// The entries are accessed one by one => No buffer for the whole table on the stack
+{
+  #if defined(ESP32)
+    char Key[8] = "EvHdr";
+    if (Nr >= 0) sprintf(Key, "Ev%i", Nr);
+    if (Write) RTC_Prefs.putBytes(Key, Data, Len);
+    else if (RTC_Prefs.getBytes(Key, Data, Len) != Len) memset(Data, 0, Len);
+  #else
+    uint16_t Addr = RTC_EVENTS_EEPROM_ADDR + (Nr < 0 ? 0 : sizeof(RTC_Event_Hdr_T) + Nr * sizeof(RTC_Event_T));
+    uint8_t *p = (uint8_t*)Data;
+    for (uint8_t i = 0; i < Len; i++, p++)
+        if (Write) EEPROM.update(Addr + i, *p);  // Only the changed bytes are written
+        else       *p = EEPROM.read(Addr + i);
+  #endif
+}
+
+//--------------------
+void RTC_Events_Load()
+//--------------------
+// Is called before the table is used the first time. At this time all instances
+// have added the dates from the configuration to the table.
+// The stored table is only used if the dates in the configuration have not been changed.
+{
+  if (RTC_Events_Loaded) return;
+  RTC_Events_Loaded = true;
+  RTC_Events_Def = RTC_Checksum(RTC_Events, RTC_Events_Cnt * sizeof(RTC_Event_T));
+  if (RTC_Events_Storage_Begin(false))
+     {
+     RTC_Event_Hdr_T Hdr;
+     RTC_Event_T     e;
+     RTC_Events_Storage(-1, &Hdr, sizeof(Hdr), false);
+     bool     Ok  = Hdr.Magic == RTC_EVENTS_MAGIC && Hdr.Cnt <= RTC_MAX_EVENTS && Hdr.Def == RTC_Events_Def;
+     uint16_t Chk = RTC_Checksum(&Hdr, offsetof(RTC_Event_Hdr_T, Chk));
+     for (uint8_t i = 0; Ok && i < Hdr.Cnt; i++)  // The checksum is tested before the table of the configuration is replaced
+         {
+         RTC_Events_Storage(i, &e, sizeof(e), false);
+         Chk = RTC_Checksum(&e, sizeof(e), Chk);
+         }
+     if (Ok && Chk == Hdr.Chk)
+        {
+        RTC_Events_Cnt = 0;
+        for (uint8_t i = 0; i < Hdr.Cnt; i++)   // Invalid dates are rejected. They would access a wrong day in the index
+            {
+            RTC_Events_Storage(i, &e, sizeof(e), false);
+            if (e.Rule == RTC_RULE_DATE && !RTC_Date_Valid(e.Day, e.Month)) continue;
+            RTC_Events[RTC_Events_Cnt++] = e;
+            }
+        RTC_Log << F("Day of year table loaded: ") << RTC_Events_Cnt << F(" entries\n");
+        if (RTC_Events_Cnt != Hdr.Cnt) RTC_Log << F("Invalid entries rejected: ") << Hdr.Cnt - RTC_Events_Cnt << endl;
+        }
+     RTC_Events_Storage_End();
+     }
+  RTC_Events_Update_Index();
+}
+
+//--------------------
+void RTC_Events_Save()
+//--------------------
+{
+  RTC_Event_Hdr_T Hdr;
+  Hdr.Magic = RTC_EVENTS_MAGIC;
+  Hdr.Cnt   = RTC_Events_Cnt;
+  Hdr.Def   = RTC_Events_Def;
+  Hdr.Chk   = RTC_Checksum(&Hdr, offsetof(RTC_Event_Hdr_T, Chk));
+  for (uint8_t i = 0; i < RTC_Events_Cnt; i++) Hdr.Chk = RTC_Checksum(&RTC_Events[i], sizeof(RTC_Event_T), Hdr.Chk);
+  if (!RTC_Events_Storage_Begin(true)) return;
+  for (uint8_t i = 0; i < RTC_Events_Cnt; i++) RTC_Events_Storage(i, &RTC_Events[i], sizeof(RTC_Event_T), true);
+  RTC_Events_Storage(-1, &Hdr, sizeof(Hdr), true); // Written at the end => An interrupted write is detected by the checksum
+  RTC_Events_Storage_End();
+}
+
+//---------------------
+void RTC_Events_Print()
+//---------------------
+{
+  Serial << F("Day of year table (") << RTC_Events_Cnt << '/' << RTC_MAX_EVENTS << F("):\n");
+  for (uint8_t i = 0; i < RTC_Events_Cnt; i++)
+      {
+      const RTC_Event_T &e = RTC_Events[i];
+      Serial << F(" Var ") << e.Var << F(": ");
+      switch (e.Rule)
+        {
+        case RTC_RULE_EASTER: Serial << F("EASTER"); if (e.Offs >= 0) Serial << '+'; Serial << e.Offs << F(" (");  break;
+        case RTC_RULE_ADVENT: Serial << F("ADVENT") << e.Offs << F(" (");                                           break;
+        }
+      Serial << e.Day << '.' << e.Month << '.';
+      if (e.Rule != RTC_RULE_DATE) Serial << ')';
+      if (RTC_Event_Daily(e)) Serial << F(" (daily)");
+      Serial << endl;
+      }
+}
+
+//------------------------------------------------
+void RTC_Event_Add_Line(uint8_t Var1, uint8_t Cnt)
+//------------------------------------------------
+// Register the variables of a RTC_DAYOFYEAR line. Called in the constructor
+{
+  RTC_Event_Line_T *l = new RTC_Event_Line_T;
+  if (!l) return;
+  l->Var1 = Var1;
+  l->Cnt  = Cnt;
+  l->Next = RTC_Event_Lines;
+  RTC_Event_Lines = l;
+}
+
+//-------------------------------
+bool RTC_Event_Var_Valid(int Var)
+//-------------------------------
+// Check if the variable belongs to a RTC_DAYOFYEAR line
+{
+  for (const RTC_Event_Line_T *l = RTC_Event_Lines; l; l = l->Next)
+      if (Var >= l->Var1 && Var < l->Var1 + l->Cnt) return true;
+  return false;
+}
+
+//---------------------------
+void RTC_Event_Cmd(char *Cmd)
+//---------------------------
+// Change the day of year table with the serial interface:
+//  E?              List the table
+//  E+dd.mm. Var    Add an event for the variable Var (Example: "E+24.07. 12", "E+0.0. 13" = daily, "E+EASTER-2 14")
+//  E-dd.mm. Var    Remove an event
+//  E!              Delete the stored table => The dates from the configuration are used after the next restart
+// The table is stored in the EEPROM (ESP32: NVS) => No new upload necessary
+{
+  RTC_Events_Load();
+  bool Ok = true;
+  const char *p = Cmd + 1;
+  switch (*Cmd)
+    {
+    case '+':
+    case '-': {
+              RTC_Event_T e;
+              int         Var;
+              if (!RTC_Read_Date(p, e) || *p == '\0')
+                   Ok = false;
+              else {
+                   Var   = atoi(p);
+                   e.Var = Var;
+                   if (*Cmd == '+' && !RTC_Event_Var_Valid(Var))
+                        {
+                        Serial << F("Variable ") << Var << F(" doesn't belong to a RTC_DAYOFYEAR line\n");
+                        break;                // The entry would never be used
+                        }
+                   if (*Cmd == '+') Ok = RTC_Event_Add(e);
+                   else             Ok = RTC_Event_Remove(e);
+                   }
+              if (Ok)
+                 {
+                 RTC_Events_Update_Index();
+                 RTC_Events_Save();
+                 }
+              }
+              break;
+    case '!': {
+              RTC_Event_Hdr_T Hdr;
+              memset(&Hdr, 0, sizeof(Hdr));
+              if (RTC_Events_Storage_Begin(true))
+                 {
+                 RTC_Events_Storage(-1, &Hdr, sizeof(Hdr), true);
+                 RTC_Events_Storage_End();
+                 }
+              Serial << F("Stored table deleted. The dates from the configuration are used after the next restart\n");
+              }
+              break;
+    }
+  if (!Ok) Serial << F("Error in day of year command\n"
+                       "Syntax:  E?  E+dd.mm. Var  E-dd.mm. Var  E!  (dd.mm. could also be EASTER+n, EASTER-n, ADVENTn)\n");
+  RTC_Events_Print();
+}
+
+//---------------------------------
+void RTC_Events_Check_Day(time_t t)
+//---------------------------------
+// Is called with each pass, but the index is only checked once per day.
+// The whole date is compared => Also a changed month or year is detected if the time is set
+{
+  tmElements_t tm;
+  RTC_Break_Time(t, tm);
+  uint16_t Ix = RTC_Day_Index(tm.Day, tm.Month);
+  if (RTC_Event_DayNr == Ix + 1 && RTC_Event_Year == tmYearToCalendar(tm.Year)) return;
+  RTC_Events_Load();
+  if (RTC_Event_Year != tmYearToCalendar(tm.Year))  // At the start, at new year and if the year is changed
+     {
+     RTC_Event_Year = tmYearToCalendar(tm.Year);
+     for (uint8_t i = 0; i < RTC_Events_Cnt; i++) RTC_Event_Resolve(RTC_Events[i]);
+     RTC_Events_Update_Index();
+     }
+  RTC_Event_DayNr  = Ix + 1;
+  RTC_Events_Today = RTC_Event_Days[Ix >> 3] & (1 << (Ix & 7));
+  RTC_Event_Gen++;
+}
+
+//----------------- End day of year events -----------------------
+
+//----------------- Sun rise / sun set -----------------------
+
+// RTC_SUN calculates the civil dawn, sunrise, sunset and civil dusk once per day and caches the
+// minutes of the day. In the loop only these values are compared with the actual time.
+// Integer arithmetic with a sine table (binary angle: 65536 = 360) => No floating point at the ATmega.
+// The accuracy is about +/-2 minutes which is enough for the lights of the layout.
+
+#ifndef RTC_SUN_LAT
+#define RTC_SUN_LAT               5100      // Latitude  [1/100] if Opt_Par is empty (Center of germany)
+#endif
+
+#ifndef RTC_SUN_LON
+#define RTC_SUN_LON               1000      // Longitude [1/100] east if Opt_Par is empty
+#endif
+
+#define RTC_SUN_NIGHT   0
+#define RTC_SUN_DAWN    1
+#define RTC_SUN_DAY     2
+#define RTC_SUN_DUSK    3
+
+typedef struct
+    {
+    int16_t  Lat;                           // [1/100] north
+    int16_t  Lon;                           // [1/100] east
+    uint16_t Doy;                           // Day of the year + 1 of the cached values (0 = Calculate)
+    bool     Summer;                        // Summer time of the cached values
+    uint16_t Minute[4];                     // Dawn, sunrise, sunset, dusk [Minutes of the day, local time]
+    } RTC_Sun_T;
+
+// sin(0 .. 90) * 32767 in steps of 256 (1.4)
+static const int16_t RTC_Sin_Tab[65] PROGMEM = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,  6393,  7179,  7962,  8739,  9512,
+    10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868,
+    19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811, 25329, 25832, 26319,
+    26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571, 30852, 31113,
+    31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757, 32767 };
+
+//-------------------------
+int16_t RTC_Sin(uint16_t a)
+//-------------------------
+// Sine of the binary angle a with linear interpolation. Result * 32767
+{
+  uint16_t x = a & 0x3FFF;
+  if (a & 0x4000) x = 0x4000 - x;
+  uint8_t  i = x >> 8;
+  uint8_t  f = x & 0xFF;
+  int16_t  v = pgm_read_word(&RTC_Sin_Tab[i]);
+  if (f) v += ((int32_t)((int16_t)pgm_read_word(&RTC_Sin_Tab[i+1]) - v) * f) >> 8;
+  return (a & 0x8000) ? -v : v;
+}
+
+//-------------------------
+int16_t RTC_Cos(uint16_t a)
+//-------------------------
+{
+  return RTC_Sin(a + 0x4000);
+}
+
+//--------------------------
+uint16_t RTC_Acos(int16_t c)
+//--------------------------
+// Binary angle 0..180 for the cosine c * 32767 (Binary search)
+{
+  uint16_t Lo = 0, Hi = 0x8000;
+  while (Hi - Lo > 1)
+    {
+    uint16_t m = (Lo + Hi) / 2;
+    if (RTC_Cos(m) > c) Lo = m;
+    else                Hi = m;
+    }
+  return Lo;
+}
+
+//----------------------------------------
+uint16_t RTC_Deg100_to_Bin(int16_t Deg100)
+//----------------------------------------
+{
+  return ((int32_t)Deg100 * 59652) >> 15;   // 65536 / 36000 = 59652 / 32768
+}
+
+//-------------------------------------
+int16_t RTC_Read_Deg100(const char* &p)
+//-------------------------------------
+// Read a coordinate like "52.52" or "-3.7" from p. Result in 1/100
+{
+  while (*p == ' ') p++;
+  bool    Neg = (*p == '-');
+  if (Neg) p++;
+  int16_t v   = 0;
+  int8_t  Dec = -1;                         // Number of decimals (-1 = No decimal point)
+  for (; (*p >= '0' && *p <= '9') || (*p == '.' && Dec < 0); p++)
+      {
+      if (*p == '.') Dec = 0;
+      else if (Dec < 2)
+              {
+              v = v * 10 + *p - '0';
+              if (Dec >= 0) Dec++;
+              }
+      }
+  if (Dec < 0) Dec = 0;
+  while (Dec++ < 2) v *= 10;
+  return Neg ? -v : v;
+}
+
+//-------------------------------------------------------------------------------------------------------
+uint16_t RTC_Sun_HourAngle(int16_t SinH0, int16_t SinLat, int16_t CosLat, int16_t SinDec, int16_t CosDec)
+//-------------------------------------------------------------------------------------------------------
+// cos(H) = (sin(h0) - sin(Lat) * sin(Dec)) / (cos(Lat) * cos(Dec))
+// Returns 0 if the sun doesn't reach the elevation h0 and 180 if it stays above the whole day
+{
+  int32_t Num = ((int32_t)SinH0 << 15) - (int32_t)SinLat * SinDec;
+  int32_t Den = ((int32_t)CosLat * CosDec) >> 15;
+  int32_t c;
+  if (Den <= 0) c = Num > 0 ? 32767 : -32767;  // Pole
+  else {
+       c = Num / Den;
+       if (c >  32767) c =  32767;
+       if (c < -32767) c = -32767;
+       }
+  return RTC_Acos(c);
+}
+
+//----------------------------------------------------
+void RTC_Sun_Calc(RTC_Sun_T &s, time_t t, bool Summer)
+//----------------------------------------------------
+// Calculate the times for the day of t. Called once per day.
+{
+  tmElements_t tm;
+  RTC_Break_Time(t, tm);
+  uint16_t N = RTC_Cal_Day_Of_Year(tmYearToY2k(tm.Year), tm.Month, tm.Day); // Day of the year starting with 0
+  s.Doy    = N + 1;
+  s.Summer = Summer;
+
+  // Declination: sin(Dec) = -0.39779 * cos(360/365 * (N + 10) + 1.914 * sin(360/365 * (N - 2)))
+  uint16_t B      = (uint32_t)(N + 10) * 65536UL / 365;
+  B              += ((int32_t)348 * RTC_Sin((uint32_t)(N + 365 - 2) * 65536UL / 365)) >> 15; // 1.914 = 348
+  int16_t  SinDec = -(((int32_t)13035 * RTC_Cos(B)) >> 15);                                   // 0.39779 = 13035 / 32768
+  int16_t  CosDec = RTC_Sin(RTC_Acos(SinDec));                                                // cos(asin(x)) = sin(acos(x))
+  uint16_t Lat    = RTC_Deg100_to_Bin(s.Lat);
+  int16_t  SinLat = RTC_Sin(Lat), CosLat = RTC_Cos(Lat);
+
+  // Equation of time [1/100 min]: 9.87 * sin(2B) - 7.53 * cos(B) - 1.5 * sin(B) with B = 360/364 * (N + 1 - 81)
+  B = (uint32_t)(N + 364 - 80) * 65536UL / 364;
+  int32_t EoT  = (987L * RTC_Sin(2 * B) - 753L * RTC_Cos(B) - 150L * RTC_Sin(B)) >> 15;
+
+  // Solar noon in local time [1/100 min]. The RTC uses the MEZ (UTC + 1h)
+  int32_t Noon = 72000L + 6000 - 4L * s.Lon - EoT + (Summer ? 6000 : 0);
+
+  static const uint16_t h0[2] = { (uint16_t)-1092, (uint16_t)-152 }; // Civil twilight -6, sunrise -0.833 (Refraction and sun radius)
+  for (uint8_t i = 0; i < 2; i++)
+      {
+      uint16_t H = RTC_Sun_HourAngle(RTC_Sin(h0[i]), SinLat, CosLat, SinDec, CosDec);
+      int32_t  From, To;
+      if (H >= 0x7FFF) { From = 0; To = 1440 * 100L; } // Above the whole day
+      else {
+           int32_t HMin = ((uint32_t)H * 1125) >> 9;      // 1/100 min (65536 = 1440 min)
+           From = Noon - HMin;
+           To   = Noon + HMin;
+           }
+      if (From < 0)          From = 0;
+      if (To   > 1440 * 100L) To  = 1440 * 100L;
+      s.Minute[i]   = (From + 50) / 100;
+      s.Minute[3-i] = (To   + 50) / 100;
+      }
+}
+
+//---------------------------------------------------------
+uint8_t RTC_Sun_Phase(const RTC_Sun_T &s, uint16_t Minutes)
+//---------------------------------------------------------
+{
+  if (Minutes <  s.Minute[0] || Minutes >= s.Minute[3]) return RTC_SUN_NIGHT;
+  if (Minutes <  s.Minute[1])                        return RTC_SUN_DAWN;
+  if (Minutes <  s.Minute[2])                        return RTC_SUN_DAY;
+  return RTC_SUN_DUSK;
+}
+
+//----------------------------------------------------------
+void RTC_Sun_Print(const RTC_Sun_T &s, Print &Out = RTC_Log)
+//----------------------------------------------------------
+{
+  Out << F("Sun:");
+  for (uint8_t i = 0; i < 4; i++)
+      {
+      Out << ' ' << s.Minute[i] / 60 << ':';
+      if (s.Minute[i] % 60 < 10) Out << '0';
+      Out << s.Minute[i] % 60;
+      }
+  Out << endl;
+}
+
+//----------------- End sun rise / sun set -----------------------
+
+//----------------- Word clock -----------------------
+
+// RTC_WORDCLOCK sets all words of a word clock with one instance. The word masks of all 144 five minute
+// steps of 12 hours are calculated by the compiler (constexpr) and stored in the flash. In the loop only
+// the changed minute is checked. Once per minute one table entry is read and written to the variables.
+// The bit number of a word is the offset to DstVar1.
+// Only the tables of the layouts enabled with RTC_WORDCLOCK_DE, RTC_WORDCLOCK_DE_VIERTEL and
+// RTC_WORDCLOCK_EN are stored (576 bytes each). Builds without word clock don't contain them.
+
+#define RTC_WC_DE          0   // "viertel nach", "halb", "viertel vor"       (Default)
+#define RTC_WC_DE_VIERTEL  1   // "viertel", "halb", "dreiviertel"            (Opt_Par "DE_VIERTEL")
+#define RTC_WC_EN          2   // "quarter past", "half past", "quarter to"   (Opt_Par "EN")
+#define RTC_WC_LAYOUTS     3
+
+// German words (RTC_WC_DE, RTC_WC_DE_VIERTEL)
+#define RTC_WC_ES          0
+#define RTC_WC_IST         1
+#define RTC_WC_FUENF_M     2
+#define RTC_WC_ZEHN_M      3
+#define RTC_WC_ZWANZIG     4
+#define RTC_WC_DREI_V      5   // "drei" of "dreiviertel"
+#define RTC_WC_VIERTEL     6
+#define RTC_WC_VOR         7
+#define RTC_WC_NACH        8
+#define RTC_WC_HALB        9
+#define RTC_WC_EIN         10  // Hours: EIN + 2 = ZWEI ... EIN + 12 = ZWOELF
+#define RTC_WC_S           11  // "s" of "eins" (Not used at the full hour: "ein Uhr")
+#define RTC_WC_UHR         23
+#define RTC_WC_DE_DOTS     24  // 4 minute dots
+
+// English words (RTC_WC_EN)
+#define RTC_WC_IT          0
+#define RTC_WC_IS          1
+#define RTC_WC_FIVE        2
+#define RTC_WC_TEN         3
+#define RTC_WC_QUARTER     4
+#define RTC_WC_TWENTY      5
+#define RTC_WC_HALF        6
+#define RTC_WC_PAST        7
+#define RTC_WC_TO          8
+#define RTC_WC_ONE         9   // Hours: ONE + 1 = TWO ... ONE + 11 = TWELVE
+#define RTC_WC_OCLOCK      21
+#define RTC_WC_EN_DOTS     22  // 4 minute dots
+
+#define _WC(Word)          ((uint32_t)1 << RTC_WC_##Word)
+
+// Minute words of the 12 five minute steps
+constexpr uint32_t RTC_WC_Min[RTC_WC_LAYOUTS][12] = {
+    { 0,                                                                                       // RTC_WC_DE
+      _WC(FUENF_M) | _WC(NACH), _WC(ZEHN_M) | _WC(NACH), _WC(VIERTEL) | _WC(NACH), _WC(ZWANZIG) | _WC(NACH),
+      _WC(FUENF_M) | _WC(VOR) | _WC(HALB),  _WC(HALB),  _WC(FUENF_M) | _WC(NACH) | _WC(HALB),
+      _WC(ZWANZIG) | _WC(VOR),  _WC(VIERTEL) | _WC(VOR),  _WC(ZEHN_M) | _WC(VOR), _WC(FUENF_M) | _WC(VOR) },
+    { 0,                                                                                       // RTC_WC_DE_VIERTEL
+      _WC(FUENF_M) | _WC(NACH), _WC(ZEHN_M) | _WC(NACH), _WC(VIERTEL), _WC(ZEHN_M) | _WC(VOR) | _WC(HALB),
+      _WC(FUENF_M) | _WC(VOR) | _WC(HALB),  _WC(HALB),  _WC(FUENF_M) | _WC(NACH) | _WC(HALB),
+      _WC(ZEHN_M) | _WC(NACH) | _WC(HALB),  _WC(DREI_V) | _WC(VIERTEL), _WC(ZEHN_M) | _WC(VOR), _WC(FUENF_M) | _WC(VOR) },
+    { 0,                                                                                       // RTC_WC_EN
+      _WC(FIVE) | _WC(PAST),    _WC(TEN) | _WC(PAST),    _WC(QUARTER) | _WC(PAST), _WC(TWENTY) | _WC(PAST),
+      _WC(TWENTY) | _WC(FIVE) | _WC(PAST),  _WC(HALF) | _WC(PAST),  _WC(TWENTY) | _WC(FIVE) | _WC(TO),
+      _WC(TWENTY) | _WC(TO),    _WC(QUARTER) | _WC(TO),  _WC(TEN) | _WC(TO),       _WC(FIVE) | _WC(TO) } };
+
+constexpr uint16_t RTC_WC_Next[RTC_WC_LAYOUTS] = { 0xFE0, 0xFF8, 0xF80 };  // Steps which show the next hour (Bit = step)
+constexpr uint8_t  RTC_WC_Dots[RTC_WC_LAYOUTS] = { RTC_WC_DE_DOTS, RTC_WC_DE_DOTS, RTC_WC_EN_DOTS };
+
+//---------------------------------------------------------------------
+constexpr uint32_t RTC_WC_Hour(uint8_t Layout, uint8_t Hour, bool Full)
+//---------------------------------------------------------------------
+// Hour word (1..12) and "Uhr"/"o'clock" at the full hour
+{
+  return Layout == RTC_WC_EN ? _WC(IT) | _WC(IS) | ((uint32_t)1 << (RTC_WC_ONE + Hour - 1)) | (Full ? _WC(OCLOCK) : 0)
+                             : _WC(ES) | _WC(IST) | ((uint32_t)1 << (RTC_WC_EIN + (Hour == 1 ? 0 : Hour))) | (Full ? _WC(UHR) : Hour == 1 ? _WC(S) : 0);
+}
+
+//----------------------------------------------------------
+constexpr uint32_t RTC_WC_Calc(uint8_t Layout, uint8_t Step)
+//----------------------------------------------------------
+// Word mask of the five minute step (0..143) of 12 hours
+{
+  return RTC_WC_Min[Layout][Step % 12] |
+         RTC_WC_Hour(Layout, (Step / 12 + ((RTC_WC_Next[Layout] >> (Step % 12)) & 1) + 11) % 12 + 1, Step % 12 == 0);
+}
+
+#define _WC_H(L, h)   RTC_WC_Calc(L, h*12+0), RTC_WC_Calc(L, h*12+1), RTC_WC_Calc(L, h*12+2),  RTC_WC_Calc(L, h*12+3), \
+                      RTC_WC_Calc(L, h*12+4), RTC_WC_Calc(L, h*12+5), RTC_WC_Calc(L, h*12+6),  RTC_WC_Calc(L, h*12+7), \
+                      RTC_WC_Calc(L, h*12+8), RTC_WC_Calc(L, h*12+9), RTC_WC_Calc(L, h*12+10), RTC_WC_Calc(L, h*12+11)
+#define _WC_12H(L)    { _WC_H(L, 0), _WC_H(L, 1), _WC_H(L, 2), _WC_H(L, 3), _WC_H(L, 4),  _WC_H(L, 5), \
+                        _WC_H(L, 6), _WC_H(L, 7), _WC_H(L, 8), _WC_H(L, 9), _WC_H(L, 10), _WC_H(L, 11) }
+
+// Word masks of all five minute steps. Calculated by the compiler.
+#ifdef RTC_WORDCLOCK_DE
+  constexpr uint32_t RTC_WC_Table_DE[144]         PROGMEM = _WC_12H(RTC_WC_DE);
+#endif
+#ifdef RTC_WORDCLOCK_DE_VIERTEL
+  constexpr uint32_t RTC_WC_Table_DE_VIERTEL[144] PROGMEM = _WC_12H(RTC_WC_DE_VIERTEL);
+#endif
+#ifdef RTC_WORDCLOCK_EN
+  constexpr uint32_t RTC_WC_Table_EN[144]         PROGMEM = _WC_12H(RTC_WC_EN);
+#endif
+
+#undef _WC_H
+#undef _WC_12H
+#undef _WC
+
+//---------------------------------------
+uint8_t RTC_WC_Read_Layout(const char *p)
+//---------------------------------------
+{
+  if (p && strcasecmp(p, "EN")         == 0) return RTC_WC_EN;
+  if (p && strcasecmp(p, "DE_VIERTEL") == 0) return RTC_WC_DE_VIERTEL;
+  return RTC_WC_DE;
+}
+
+//----------------------------------------------------
+uint32_t RTC_WC_Mask(uint8_t Layout, uint16_t Minutes)
+//----------------------------------------------------
+// Words and minute dots. Returns 0 if the table of the layout is not enabled.
+{
+  const uint32_t *Tab;
+  switch (Layout)
+    {
+    #ifdef RTC_WORDCLOCK_DE
+      case RTC_WC_DE:         Tab = RTC_WC_Table_DE;         break;
+    #endif
+    #ifdef RTC_WORDCLOCK_DE_VIERTEL
+      case RTC_WC_DE_VIERTEL: Tab = RTC_WC_Table_DE_VIERTEL; break;
+    #endif
+    #ifdef RTC_WORDCLOCK_EN
+      case RTC_WC_EN:         Tab = RTC_WC_Table_EN;         break;
+    #endif
+    default:                  return 0;
+    }
+  return pgm_read_dword(&Tab[(Minutes / 5) % 144]) |
+         ((((uint32_t)1 << (Minutes % 5)) - 1) << RTC_WC_Dots[Layout]);   // Minute dots 1..4
+}
+
+//----------------- End word clock -----------------------
+
+//----------------- Brightness curve -----------------------
+
+// RTC_BRIGHT outputs a brightness level which depends on the time of the day. The curve is defined
+// with breakpoints "hh:mm=Level" in Opt_Par. Between the breakpoints the level is interpolated linear.
+// The curve is converted to a table with one entry every RTC_BRIGHT_STEP minutes in the constructor.
+// Once per minute the level is interpolated between two table entries. The variables are only
+// written if the level changes.
+
+#ifndef RTC_BRIGHT_STEP
+#define RTC_BRIGHT_STEP           15        // Minutes between the table entries (Divider of 1440)
+#endif
+
+#define RTC_BRIGHT_MAX_POINTS     12        // Maximal number of breakpoints in Opt_Par
+#define RTC_BRIGHT_LUT_SIZE       (1440 / RTC_BRIGHT_STEP)
+
+//---------------------------------------------------------------------------------------------------
+uint8_t RTC_Bright_Interpolate(const uint16_t *Minute, const uint8_t *Level, uint8_t Cnt, uint16_t m)
+//---------------------------------------------------------------------------------------------------
+// Level at the minute m between the breakpoints (sorted by the time). The curve is continued over midnight.
+{
+  uint8_t  n = 0;
+  while (n < Cnt && Minute[n] <= m) n++;                     // n = Next breakpoint
+  uint8_t  p = n ? n - 1 : Cnt - 1;                          // Previous breakpoint
+  if (n == Cnt) n = 0;
+  int32_t  Len  = (Minute[n] + 1440 - Minute[p]) % 1440;    // Length of the segment
+  if (Len == 0) return Level[p];                             // Only one breakpoint
+  int32_t  Pos  = (m + 1440 - Minute[p]) % 1440;
+  int32_t  Diff = (int16_t)Level[n] - Level[p];
+  return Level[p] + (Diff * Pos * 2 + (Diff > 0 ? Len : -Len)) / (2 * Len); // Rounded
+}
+
+//-----------------------------------------------------------
+uint8_t *RTC_Bright_Make_Lut(const char *p, uint8_t MaxLevel)
+//-----------------------------------------------------------
+// Read the breakpoints "hh:mm=Level hh:mm=Level ..." and calculate the table.
+// Returns NULL if there are no valid breakpoints or if there is not enough memory.
+{
+  uint16_t Minute[RTC_BRIGHT_MAX_POINTS];
+  uint8_t  Level[RTC_BRIGHT_MAX_POINTS];
+  uint8_t  Cnt = 0;
+  while (p && *p && Cnt < RTC_BRIGHT_MAX_POINTS)
+    {
+    while (*p == ' ') p++;
+    if (!isdigit(*p)) break;
+    uint16_t h = strtoul(p, (char**)&p, 10), m = 0;
+    if (*p == ':') m = strtoul(p+1, (char**)&p, 10);
+    if (*p != '=' || h > 23 || m > 59) break;
+    uint16_t l = strtoul(p+1, (char**)&p, 10);
+    uint16_t t = h * 60 + m;
+    uint8_t  i = Cnt++;
+    while (i > 0 && Minute[i-1] > t) { Minute[i] = Minute[i-1]; Level[i] = Level[i-1]; i--; } // Insertion sort
+    Minute[i] = t;
+    Level[i]  = l > MaxLevel ? MaxLevel : l;
+    }
+  if (Cnt == 0) return NULL;
+  uint8_t *Lut = (uint8_t*)malloc(RTC_BRIGHT_LUT_SIZE + 1);  // The last entry is the first entry of the next day
+  if (!Lut) return NULL;
+  for (uint16_t i = 0; i <= RTC_BRIGHT_LUT_SIZE; i++)
+      Lut[i] = RTC_Bright_Interpolate(Minute, Level, Cnt, (i * RTC_BRIGHT_STEP) % 1440);
+  return Lut;
+}
+
+//------------------------------------------------------
+uint8_t RTC_Bright_Level(const uint8_t *Lut, uint16_t m)
+//------------------------------------------------------
+// Interpolation between the table entries. Called once per minute.
+{
+  uint16_t i   = m / RTC_BRIGHT_STEP;
+  uint8_t  Pos = m - i * RTC_BRIGHT_STEP;
+  int16_t  d   = Lut[i+1] - Lut[i];
+  return Lut[i] + (d * Pos * 2 + (d > 0 ? RTC_BRIGHT_STEP : -RTC_BRIGHT_STEP)) / (2 * RTC_BRIGHT_STEP);
+}
+
+//----------------- End brightness curve -----------------------
+
+//----------------- Warm start -----------------------
+
+// After a watchdog or software reset (Also the daily restart at RTC_RESTART_HOUR) the software clock
+// and the timers of RTC_DAYOFYEAR are restored from a RAM block which is not cleared by the startup code.
+// The compile time check and the first RTC read are skipped. The clock is synchronized with the RTC
+// in the background by RTC_Sync_Loop() => The LEDs show the correct state immediately after the restart.
+// The requests of the temperature sensor are deferred until this synchronization is finished.
+// A time adjustment which is not written to the RTC (RTC_Write_Pending) is written after the restart.
+// The block is saved once per second in RTC_loop(). It's only used if the checksum and the compile time
+// are correct. After a power on reset the content of the RAM is random => Cold start.
+
+#ifndef RTC_WARM_INSTANCES
+  #ifdef ESP32
+    #define RTC_WARM_INSTANCES      4       // Number of RTC_DAYOFYEAR lines which are restored
+  #else
+    #define RTC_WARM_INSTANCES      1       // Needs 4 * MAXDATES bytes RAM per instance
+  #endif
+#endif
+
+#define RTC_WARM_MAGIC            0x57A3
+
+#ifdef ESP32
+  #include <esp_system.h>                   // esp_reset_reason()
+  #define RTC_NOINIT                RTC_NOINIT_ATTR                 // RTC slow memory, not cleared at a reset
+#else
+  #define RTC_NOINIT                __attribute__((section(".noinit")))
+#endif
+
+typedef struct
+    {
+    uint16_t Magic;
+    uint16_t Stamp;                                   // Checksum of the compile time => Cold start after an upload
+    uint32_t Time;                                    // Software clock at the last second boundary (Winter time)
+    uint32_t Disp[RTC_WARM_INSTANCES][MAXDATES];      // DayOfYearDisplayTime of the RTC_DAYOFYEAR instances relative to millis()
+    uint16_t Write_Pending;                           // RTC_Write_Pending: The adjusted time has not been written to the RTC
+    uint16_t Chk;
+    } RTC_Warm_T;
+
+RTC_NOINIT RTC_Warm_T RTC_Warm;
+static uint32_t *RTC_Warm_Reg[RTC_WARM_INSTANCES];    // DayOfYearDisplayTime of the instances (Registered after the timers are initialized)
+static uint8_t   RTC_Warm_Cnt     = 0;                // Number of RTC_DAYOFYEAR instances
+static bool      RTC_Warm_Started = false;            // The actual start was a warm start
+
+//-----------------------
+uint16_t RTC_Warm_Stamp()
+//-----------------------
+{
+  static const char Compile[] = __DATE__ " " __TIME__;
+  return RTC_Checksum(Compile, sizeof(Compile));
+}
+
+//-------------------
+bool RTC_Warm_Start()
+//-------------------
+// Called once by RTC_setup(). Returns true if the RAM block is valid after a watchdog/software reset.
+// In this case the time of the last second boundary is used until RTC_Sync_Loop() has read the RTC.
+{
+  #ifdef ESP32
+    esp_reset_reason_t r = esp_reset_reason();
+    bool Soft = r == ESP_RST_SW || r == ESP_RST_PANIC || r == ESP_RST_INT_WDT || r == ESP_RST_TASK_WDT || r == ESP_RST_WDT;
+  #else
+    uint8_t Flags = MCUSR;
+    MCUSR = 0;                                        // The flags stay set until they are cleared. Old bootloaders don't clear them
+    bool Soft = !(Flags & (_BV(PORF) | _BV(BORF)));   // The bootloader may have cleared the flags => The checksum decides
+  #endif
+  RTC_Warm_Started = Soft && RTC_Warm.Magic == RTC_WARM_MAGIC && RTC_Warm.Stamp == RTC_Warm_Stamp() &&
+                     RTC_Warm.Chk == RTC_Checksum(&RTC_Warm, offsetof(RTC_Warm_T, Chk));
+  if (RTC_Warm_Started)
+       {
+       RTC_Set_Time(RTC_Warm.Time + 1, millis());     // The reset has been in the following second
+       if (RTC_Warm.Write_Pending)                    // The adjusted time is written at the next second boundary
+          {
+          RTC_Write_Pending = true;
+          RTC_Last_Adjust   = millis() - RTC_ADJUST_WRITE_DELAY - 1;
+          }
+       }
+  else memset(&RTC_Warm, 0, sizeof(RTC_Warm));
+  return RTC_Warm_Started;
+}
+
+//--------------------------
+void RTC_Warm_Save(time_t t)
+//--------------------------
+// Called once per second at the second boundary
+{
+  static uint16_t Stamp = RTC_Warm_Stamp();
+  RTC_Warm.Magic = RTC_WARM_MAGIC;
+  RTC_Warm.Stamp = Stamp;
+  RTC_Warm.Time  = t;
+  RTC_Warm.Write_Pending = RTC_Write_Pending;
+  uint32_t mil = millis();                            // millis() restarts with 0 => The remaining times are stored
+  for (uint8_t i = 0; i < RTC_WARM_INSTANCES; i++)
+      if (RTC_Warm_Reg[i])
+         for (uint8_t j = 0; j < MAXDATES; j++) RTC_Warm.Disp[i][j] = RTC_Warm_Reg[i][j] - mil;
+  RTC_Warm.Chk   = RTC_Checksum(&RTC_Warm, offsetof(RTC_Warm_T, Chk));
+}
+
+//----------------- End warm start -----------------------
+
 //***********************************
 class RT_Clock : public MLLExtension
 //***********************************
@@ -678,13 +2495,24 @@ class RT_Clock : public MLLExtension
     uint8_t     Next_ExtStartNr;
     bool        Par_Read;
     uint8_t     DatesCnt;
-    uint8_t     Day[MAXDATES];
-    uint8_t     Month[MAXDATES];
+    uint16_t    Today_Mask;   // One bit for each output which has an event at the actual day
+    uint16_t    Daily_Mask;   // One bit for each daily event ("0.0.")
+    uint8_t     Event_Gen;
     bool        OldActiv[MAXDATES];
     bool        Old_ExtInp;
     bool        ExtActiv;
+    uint32_t    ExtInpStartTime;
+    bool        KeyLong;
+    bool        Timer_Init;
+    uint8_t     Warm_Nr;      // RTC_DAYOFYEAR: Number of the timers in the warm start block
     uint32_t    Set_Zeit2_Time;
+    bool        Zeit2_Armed;  // Set_Zeit2_Time is valid
     bool        FirstInstanze;
+    RTC_Sun_T  *Sun;          // Only allocated for RTC_SUN
+    uint8_t     WC_Layout;    // RTC_WORDCLOCK: RTC_WC_DE, RTC_WC_DE_VIERTEL, RTC_WC_EN
+    uint16_t    Last_Minute;  // RTC_WORDCLOCK, RTC_BRIGHT: Minute of the last output (0xFFFF = Outputs disabled)
+    uint8_t    *Bright_Lut;   // RTC_BRIGHT: Level table (Only allocated for RTC_BRIGHT)
+    uint8_t     Bright_Level; // RTC_BRIGHT: Actual output level
 
   #ifdef RTC_DEBUG
     uint16_t Ctr;
@@ -704,13 +2532,25 @@ class RT_Clock : public MLLExtension
       this->DstVarN        = DstVarN;
       for (uint8_t i = 0; i < MAXDATES; i++)
           DayOfYearDisplayTime[i] = RTC_FIRST_DAYOFYEAR_DISP + random(0,50);
-      //ExtInpStartTime      = 0;
+      ExtInpStartTime      = 0;
+      KeyLong              = false;
+      Timer_Init           = false;
+      Warm_Nr              = 255;
       Next_ExtStartNr      = 0;
       DatesCnt             = 0;
+      Today_Mask           = 0;
+      Daily_Mask           = 0;
+      Event_Gen            = RTC_Event_Gen;
       Old_ExtInp           = false;
       ExtActiv             = false;
       Set_Zeit2_Time       = 0;
+      Zeit2_Armed          = false;
       FirstInstanze        = false;
+      Sun                  = NULL;
+      WC_Layout            = RTC_WC_DE;
+      Last_Minute          = 0xFFFE;  // Not used => Set at the first call
+      Bright_Lut           = NULL;
+      Bright_Level         = 0;
       switch (Clock_Type & _RTC_MODE_MASK)
         {
         case RTC_CONTR_VAR:     // Controller variables
@@ -721,11 +2561,28 @@ class RT_Clock : public MLLExtension
                                    }
                                 break;
         case RTC_DAYOFYEAR:     Read_Par();
-                                for (uint8_t i = 0; i < DatesCnt; i++)
-                                    {
-                                    // Don't show the standard events (like "Stummi Forum") at the start of the program
-                                    if (Day[i] == 0) DayOfYearDisplayTime[i] = random(RTC_RANDDAY_PERIOD_MIN, RTC_RANDDAY_PERIOD_MAX);
-                                    }
+                                RTC_Event_Add_Line(DstVar1, DatesCnt);                                // 19.10.26: Check of the serial commands
+                                Warm_Nr = RTC_Warm_Cnt++;                                             // 19.10.26:
+                                break;
+        case RTC_SUN:           Sun = new RTC_Sun_T;                                                  // 19.10.26:
+                                if (Sun)
+                                   {
+                                   const char *p = ParTxt;
+                                   if (p && *p)
+                                        {
+                                        Sun->Lat = RTC_Read_Deg100(p);
+                                        Sun->Lon = RTC_Read_Deg100(p);
+                                        }
+                                   else {
+                                        Sun->Lat = RTC_SUN_LAT;
+                                        Sun->Lon = RTC_SUN_LON;
+                                        }
+                                   Sun->Doy = 0;
+                                   }
+                                break;
+        case RTC_WORDCLOCK:     WC_Layout = RTC_WC_Read_Layout(ParTxt);                               // 19.10.26:
+                                break;
+        case RTC_BRIGHT:        Bright_Lut = RTC_Bright_Make_Lut(ParTxt, Bright_Max());               // 19.10.26:
                                 break;
         }
 	}
@@ -745,10 +2602,17 @@ class RT_Clock : public MLLExtension
        FirstInstanze = true;
        RTC_setup();
        }
+     if (RTC_Warm_Started && Warm_Nr < RTC_WARM_INSTANCES)                                                  // 19.10.26: Continue the timers
+        {
+        uint32_t mil = millis();
+        for (uint8_t i = 0; i < MAXDATES; i++) DayOfYearDisplayTime[i] = mil + RTC_Warm.Disp[Warm_Nr][i];
+        RTC_Warm_Reg[Warm_Nr] = DayOfYearDisplayTime;
+        Timer_Init = true;
+        }
      if (Contr_Var_Def)
         {
-        mobaLedLib.Set_Input(Contr_Var+1, 1); // Zeit1 = Zeit_An
-        mobaLedLib.Set_Input(Contr_Var+2, 1); // Zeit2 = Zeit_Verz
+        Set_Var(mobaLedLib, Contr_Var+1, 1); // Zeit1 = Zeit_An
+        Set_Var(mobaLedLib, Contr_Var+2, 1); // Zeit2 = Zeit_Verz
         }
 	}
 
@@ -759,15 +2623,69 @@ class RT_Clock : public MLLExtension
       Par_Read = true;
       //Serial << F("ParTxt:") << ParTxt << endl;
       const char *p = ParTxt;
-      while (DatesCnt < MAXDATES)
+      DatesCnt = DstVarN - DstVar1 + 1;  // Events could also be added later with the serial interface
+      if (DatesCnt > MAXDATES) DatesCnt = MAXDATES;
+      if (!p) return;
+      for (uint8_t Nr = 0; Nr < DatesCnt; Nr++)
         {
-        Day[DatesCnt] = ReadNr(p, '.');
-        if (p && *p) Month[DatesCnt] = ReadNr(p, '.');
-        else         return;
-        DatesCnt++;
+        while (*p == ' ') p++;
+        if (!*p) return;
+        RTC_Event_T e;
+        if (!RTC_Read_Date(p, e))                                                                            // 19.10.26: Also movable holidays
+           {
+           RTC_Log << F("RTC_DAYOFYEAR: Syntax error in entry ") << Nr + 1 << endl;  // Sent after the start
+           continue;
+           }
+        e.Var = DstVar1 + Nr;
+        RTC_Event_Add(e);
+        // Don't show the standard events (like "Stummi Forum") at the start of the program
+        if (RTC_Event_Daily(e)) DayOfYearDisplayTime[Nr] = random(RTC_RANDDAY_PERIOD_MIN, RTC_RANDDAY_PERIOD_MAX);
         }
     }
 
+    //---------------------------------------
+    private:void Update_Event_Masks(time_t t)                                                                 // 19.10.26:
+    //---------------------------------------
+    // Called once per day or after a change of the day of year table
+    {
+      tmElements_t tm;
+      RTC_Break_Time(t, tm);
+      Event_Gen  = RTC_Event_Gen;
+      Today_Mask = 0;
+      Daily_Mask = 0;
+      for (uint8_t i = 0; i < RTC_Events_Cnt; i++)
+          {
+          const RTC_Event_T &e = RTC_Events[i];
+          uint8_t Nr = e.Var - DstVar1;
+          if (e.Var < DstVar1 || Nr >= DatesCnt) continue; // Event of an other instance
+          if (RTC_Event_Daily(e))
+               Daily_Mask |= 1 << Nr;
+          else if (RTC_Events_Today && e.Day == tm.Day && e.Month == tm.Month)
+               Today_Mask |= 1 << Nr;
+          }
+    }
+
+    //-------------------------------------------------------------------
+    private:void Set_Var(MobaLedLib_C& mobaLedLib, uint8_t Var, bool Val)                                     // 19.10.26:
+    //-------------------------------------------------------------------
+    // All variables are set with this function to be able to record them in the trace buffer
+    {
+      #if RTC_TRACE_SIZE > 0
+        RTC_Trace_Var(Var, Val, Clock_Type, DstVar1);
+      #endif
+      mobaLedLib.Set_Input(Var, Val);
+    }
+
+    //------------------------------------
+    private:void Set_ActiveNr(uint16_t Nr)
+    //------------------------------------
+    {
+      #if RTC_TRACE_SIZE > 0
+        if (Nr != ActiveNr) RTC_Trace_Add(RTC_TR_ACTIVE, Nr, 0, Clock_Type, DstVar1);
+      #endif
+      ActiveNr = Nr;
+    }
+
     //--------------------------------------------------------------------------------
     private:void Set_Variables(MobaLedLib_C& mobaLedLib, uint8_t Val, uint8_t BarMode)
     //--------------------------------------------------------------------------------
@@ -777,14 +2695,104 @@ class RT_Clock : public MLLExtension
            uint8_t  Cnt = 0;
            for (uint8_t VarNr = DstVar1; VarNr <= DstVarN; VarNr++, Cnt++)
                if (BarMode)
-                    mobaLedLib.Set_Input(VarNr,Val >= Cnt );
-               else mobaLedLib.Set_Input(VarNr,Val == Cnt );
+                    Set_Var(mobaLedLib, VarNr,Val >= Cnt );
+               else Set_Var(mobaLedLib, VarNr,Val == Cnt );
            }
       else {
            uint16_t Mask = 1;
            for (uint8_t VarNr = DstVar1; VarNr <= DstVarN; VarNr++, Mask <<= 1)
-               mobaLedLib.Set_Input(VarNr, Val & Mask);
+               Set_Var(mobaLedLib, VarNr, Val & Mask);
+           }
+    }
+
+    //-----------------------------------------------------------
+    private:void Adjust_Key(MobaLedLib_C& mobaLedLib, int8_t Dir)                                             // 19.10.26:
+    //-----------------------------------------------------------
+    // Short press: Adjust the time by 5 minutes in the direction Dir when the button is released
+    // Long press:  Adjust the time backwards and repeat it as long as the button is hold
+    {
+      bool     Inp = Inp_Is_On(mobaLedLib.Get_Input(InCh));
+      uint32_t mil = millis();
+      if (Inp && !Old_ExtInp)
+         {
+         ExtInpStartTime = mil;
+         KeyLong         = false;
+         }
+      else if (Inp)
+         {
+         if (mil - ExtInpStartTime >= (uint32_t)(KeyLong ? RTC_KEY_REPEAT : RTC_KEY_LONG_PRESS)) // Overflow save calculation
+            {
+            ExtInpStartTime = mil;
+            KeyLong         = true;
+            RTC_Adjust_Time(-5 * Dir);
+            }
+         }
+      else if (Old_ExtInp && !KeyLong) RTC_Adjust_Time(5 * Dir);
+      Old_ExtInp = Inp;
+    }
+
+    //-----------------------------------------------------------------
+    private:void Word_Clock(MobaLedLib_C& mobaLedLib, uint16_t Minutes)                                     // 19.10.26:
+    //-----------------------------------------------------------------
+    // All words are written together if the minute changes
+    {
+      uint16_t Key = Disable_Outputs ? 0xFFFF : Minutes;
+      if (Key == Last_Minute) return;
+      if (Last_Minute == 0xFFFE && RTC_WC_Mask(WC_Layout, 0) == 0) // At 12 o'clock there are always words => Table not enabled
+         RTC_Log << F("RTC_WORDCLOCK: Layout not enabled (#define RTC_WORDCLOCK_DE, RTC_WORDCLOCK_DE_VIERTEL or RTC_WORDCLOCK_EN)\n");
+      Last_Minute = Key;
+      uint32_t Mask = 0;
+      if (!Disable_Outputs) Mask = RTC_WC_Mask(WC_Layout, Minutes);
+      for (uint8_t VarNr = DstVar1; VarNr <= DstVarN; VarNr++, Mask >>= 1)
+          Set_Var(mobaLedLib, VarNr, Mask & 1);
+    }
+
+    //--------------------------
+    private:uint8_t Bright_Max()
+    //--------------------------
+    // Maximal level for the number of variables
+    {
+      uint8_t Cnt = DstVarN - DstVar1 + 1;
+      if (Clock_Type & RTC_BAR)    return Cnt;
+      if (Clock_Type & RTC_SINGLE) return Cnt - 1;
+      return Cnt >= 8 ? 255 : (1 << Cnt) - 1;
+    }
+
+    //-----------------------------------------------------------------
+    private:void Brightness(MobaLedLib_C& mobaLedLib, uint16_t Minutes)                                       // 19.10.26:
+    //-----------------------------------------------------------------
+    // The level is calculated once per minute. The variables are only written if it has been changed.
+    {
+      uint16_t Key = Disable_Outputs ? 0xFFFF : Minutes;
+      if (Key == Last_Minute || !Bright_Lut) return;
+      bool First  = (Last_Minute == 0xFFFE);
+      Last_Minute = Key;
+      uint8_t Level = Disable_Outputs ? 0 : RTC_Bright_Level(Bright_Lut, Minutes);
+      if (Level == Bright_Level && !First) return;
+      Bright_Level = Level;
+      if (Clock_Type & RTC_BAR)
+           {
+           uint8_t Cnt = 0;
+           for (uint8_t VarNr = DstVar1; VarNr <= DstVarN; VarNr++, Cnt++)
+               Set_Var(mobaLedLib, VarNr, Level > Cnt);
            }
+      else Set_Variables(mobaLedLib, Level, 0);
+    }
+
+    //------------------------------------------------------------------
+    private:uint8_t Sun_Phase(time_t t, bool SummerTime, uint16_t Minutes)                                   // 19.10.26:
+    //------------------------------------------------------------------
+    // The sun times are calculated once per day. Here only the cached values are compared.
+    {
+      if (!Sun) return RTC_SUN_NIGHT;
+      tmElements_t tm;
+      RTC_Break_Time(t, tm);
+      if (Sun->Doy != RTC_Cal_Day_Of_Year(tmYearToY2k(tm.Year), tm.Month, tm.Day) + 1 || Sun->Summer != SummerTime) // Not the day of month => A date set to an other month is detected
+         {
+         RTC_Sun_Calc(*Sun, t, SummerTime);
+         if (RTC_Log.Begin(RTC_LOG_DIAG)) RTC_Sun_Print(*Sun);
+         }
+      return RTC_Sun_Phase(*Sun, Minutes);
     }
 
     #ifdef RTC_DEBUG
@@ -817,6 +2825,8 @@ class RT_Clock : public MLLExtension
                    case RTC_5MIN_OFFS: Inc = 1;  break;
                    case RTC_HOUR_WC1:  Inc = 60; break;
                    case RTC_HOUR_WC2:  Inc = 60; break;
+                   case RTC_SUN:       Inc = 15; break;
+                   default:            Inc = 0;  break;
                    }
                  RTC_Minutes += Inc;
                  }
@@ -854,16 +2864,20 @@ class RT_Clock : public MLLExtension
 
       #ifdef RTC_DEBUG
          uint8_t DebugPrint = Debug_Set_RTC_Minutes(mobaLedLib, CType);  // Debug
+         RTC_Log.Drain();
       #else
          RTC_loop();
          time_t  t = now();
-         boolean SummerTime = summertime_RAMsave(year(t), month(t), day(t), hour(t), 1);
+         boolean SummerTime = RTC_Summer_Time(t);                                                           // 19.10.26: Calendar kernel instead of the Time library
          if (SummerTime) t += 3600;
-         uint16_t RTC_Minutes = hour(t) * 60 + minute(t);
+         tmElements_t tm;
+         RTC_Break_Time(t, tm);
+         uint16_t RTC_Minutes = tm.Hour * 60 + tm.Minute;
 
-         if (FirstInstanze && hour(t) == RTC_RESTART_HOUR && minute(t) == RTC_RESTART_MINUTE && second(t) == 0)
+         if (FirstInstanze && tm.Hour == RTC_RESTART_HOUR && tm.Minute == RTC_RESTART_MINUTE && tm.Second == 0)
             {
-            Serial << F("Restarting...\n");
+            RTC_Log << F("Restarting...\n");
+            RTC_Log.Flush();
             while (1)
                 {
                 // Wait for watchdog restart
@@ -874,8 +2888,10 @@ class RT_Clock : public MLLExtension
       #if !USE_RTC_TEMP_SENS
         {
         static uint32_t Last_TempRead = 0;
+        static bool     Deferred      = RTC_Warm_Started;                                                 // 19.10.26: Warm start: No request until the clock is synchronized
         uint32_t t = millis();
-        if (t - Last_TempRead > 1000) // Overflow save calculation
+        if (Deferred) Deferred = RTC_Sync_State != RTC_SYNC_IDLE;
+        if (!Deferred && t - Last_TempRead > 1000) // Overflow save calculation
            {
            Last_TempRead = t;
            sensors.requestTemperatures(); // The temperatur is read in async mode (setWaitForConversion(false)) because it takes about 500ms to read the temperatur
@@ -897,15 +2913,17 @@ class RT_Clock : public MLLExtension
       #ifdef RTC_DEBUG
         case RTC_WDAY:      Val =   RTC_SimWDay;                                              break;  // 1..7, 1 = sunday, 2=Mo, 3=Di, 4=Mi, 5=Do, 6=Fr, 7=Sa
         case RTC_TEMP_WC:   TempC = RTC_SimTemp;                                              break;  // 1..12 (18C - 29C) 0 = Aus
+        case RTC_SUN:       Val =   Sun_Phase(now(), false, RTC_Minutes);      DisabVal = 4;  break;  // 0..3
       #else
-        case RTC_WDAY:      Val =   weekday(t);                                               break;  // 1..7, 1 = sunday
+        case RTC_WDAY:      Val =   tm.Wday;                                                  break;  // 1..7, 1 = sunday
+        case RTC_SUN:       Val =   Sun_Phase(t, SummerTime, RTC_Minutes);     DisabVal = 4;  break;  // 0..3 Night, dawn, day, dusk
         case RTC_TEMP_WC:
              #if USE_RTC_TEMP_SENS
-                            TempC = (myRTC.temperature()+2) / 4.0;                            break;  // +2 for correct rounding
+                            TempC = (RTC_Temperature()+2) / 4.0;                              break;  // +2 for correct rounding
              #else
                             TempC = round(sensors.getTempCByIndex(0));
                             if (TempC == -127) // In case no DS18B20 is connected we use the internal sensor in the RTC
-                                TempC = (myRTC.temperature()+2) / 4.0;
+                                TempC = (RTC_Temperature()+2) / 4.0;
                             break;
              #endif
       #endif
@@ -913,6 +2931,8 @@ class RT_Clock : public MLLExtension
         case RTC_5MIN_OFFS: Val =   RTC_Minutes % 5;                                          break;  // 0..4
         case RTC_HOUR_WC1:  Val = ((RTC_Minutes+40)/60)%12; if(Val==0) Val=12;                break;  // 1..12 Hour is switched @ xx:20 => use "zwanzig nach xx"
         case RTC_HOUR_WC2:  Val = ((RTC_Minutes+35)/60)%12; if(Val==0) Val=12;                break;  // 1..12 Hour is switched @ xx:25 => use "zehn vor halb xx"
+        case RTC_WORDCLOCK: Word_Clock(mobaLedLib, RTC_Minutes);                              return; // 19.10.26:
+        case RTC_BRIGHT:    Brightness(mobaLedLib, RTC_Minutes);                              return; // 19.10.26:
         case RTC_OFF:       {
                             uint8_t Inp = mobaLedLib.Get_Input(InCh);
                             Disable_Outputs = Inp_Is_On(Inp);                  // Disable all
@@ -921,19 +2941,30 @@ class RT_Clock : public MLLExtension
         case RTC_DAYOFYEAR: {
                             #ifdef RTC_DEBUG
                               if (InCh != SI_1) Val = Inp_Is_On(mobaLedLib.Get_Input(InCh));
-                              mobaLedLib.Set_Input(DstVar1, Val);
+                              Set_Var(mobaLedLib, DstVar1, Val);
                             #else
                               bool Inp = (InCh != SI_1 && Inp_Is_On(mobaLedLib.Get_Input(InCh)));
                               bool ExtInp = (Inp && Old_ExtInp == false);
                               //if (ExtInp) Serial << "ExtInp!!\n";
                               Old_ExtInp = Inp;
 
-                              uint32_t mil = millis();
+                              RTC_Events_Check_Day(t);                                                // 19.10.26:
+                              if (Event_Gen != RTC_Event_Gen) Update_Event_Masks(t);
+                              uint16_t Active_Mask = Today_Mask | Daily_Mask;
+
+                              uint32_t mil = millis();                                                // 19.10.26: Not now_ms() => Setting the time doesn't shift the timers
+                              if (!Timer_Init)                                                        // The times are relative to the start of the program
+                                 {
+                                 Timer_Init = true;
+                                 for (uint8_t i = 0; i < MAXDATES; i++) DayOfYearDisplayTime[i] += mil;
+                                 if (Warm_Nr < RTC_WARM_INSTANCES) RTC_Warm_Reg[Warm_Nr] = DayOfYearDisplayTime; // 19.10.26: Saved for a warm start
+                                 }
                               uint8_t Nr = 0;
                               for (Nr = 0; Nr < DatesCnt; Nr++)
                                  {
                                  Val = 0;
-                                 if (Day[Nr] == 0 || (Day[Nr] == day(t) && Month[Nr] == month(t)) || (ExtInp && Nr == Next_ExtStartNr) || ExtActiv)
+                                 bool Daily = (Daily_Mask >> Nr) & 1;
+                                 if (((Active_Mask >> Nr) & 1) || (ExtInp && Nr == Next_ExtStartNr) || ExtActiv)
                                     {
                                     if (ExtInp && Nr == Next_ExtStartNr) // The Output could be enabled/disabled with an external trigger (Button)
                                        {
@@ -942,18 +2973,18 @@ class RT_Clock : public MLLExtension
                                        else { ExtActiv = false;                                  // Disable and set the next start time
                                               // Wird aufgerufen wenn bereits ein anderer Event luft
                                               // Damit wird dafr gesorgt, dass der Event spter nochmal kommt
-                                              if (Day[Nr] > 0)
+                                              if (!Daily)
                                                    DayOfYearDisplayTime[Nr] = mil + random(RTC_DAYOFYEAR_PERIOD_MIN, RTC_DAYOFYEAR_PERIOD_MAX);
                                               else DayOfYearDisplayTime[Nr] = mil + random(RTC_RANDDAY_PERIOD_MIN,   RTC_RANDDAY_PERIOD_MAX);
-                                              //Serial << "Day:" << Day[Nr] << " Nr:" << Nr << " DayOfYearDisplayTime=" << DayOfYearDisplayTime[Nr] - mil << endl;
+                                              //Serial << "Daily:" << Daily << " Nr:" << Nr << " DayOfYearDisplayTime=" << DayOfYearDisplayTime[Nr] - mil << endl;
                                             }
                                        }
 
-                                    if (mil >= DayOfYearDisplayTime[Nr]) // ToDo: Avoid overflow
+                                    if ((int32_t)(mil - DayOfYearDisplayTime[Nr]) >= 0) // Overflow save calculation
                                        {
-                                       if (mil >= DayOfYearDisplayTime[Nr] + (Day[Nr]>0?RTC_DAYOFYEAR_IMP_DURATION:RTC_RANDDAY_INP_DURATION) || (ActiveNr != NO_ACTIVE_NR && ActiveNr != DstVar1+Nr))
+                                       if ((int32_t)(mil - DayOfYearDisplayTime[Nr]) >= (!Daily?RTC_DAYOFYEAR_IMP_DURATION:RTC_RANDDAY_INP_DURATION) || (ActiveNr != NO_ACTIVE_NR && ActiveNr != DstVar1+Nr))
                                             { // Set next time to display the text
-                                            if (Day[Nr] > 0)
+                                            if (!Daily)
                                                  DayOfYearDisplayTime[Nr] = mil + random(RTC_DAYOFYEAR_PERIOD_MIN, RTC_DAYOFYEAR_PERIOD_MAX);
                                             else DayOfYearDisplayTime[Nr] = mil + random(RTC_RANDDAY_PERIOD_MIN,   RTC_RANDDAY_PERIOD_MAX);
                                             //Serial << "Set next time for Nr:" << Nr << endl;
@@ -971,17 +3002,18 @@ class RT_Clock : public MLLExtension
                                     OldActiv[Nr] = Val;
                                     if (Contr_Var_Def) // Enabled if function RTC_CONTR_VAR is used
                                          {
-                                         mobaLedLib.Set_Input(Contr_Var+0,  Val);     // Zeit0 = Zeit Anzeige Aus
-                                         mobaLedLib.Set_Input(Contr_Var+1, !Val);     // Zeit1 = Zeit Anzeige An
+                                         Set_Var(mobaLedLib, Contr_Var+0,  Val);     // Zeit0 = Zeit Anzeige Aus
+                                         Set_Var(mobaLedLib, Contr_Var+1, !Val);     // Zeit1 = Zeit Anzeige An
                                          if (Val == 1)
                                               {
                                               Set_Zeit2_Time = mil + RTC_ZEIT2_DELAY;
+                                              Zeit2_Armed    = true;                                   // 19.10.26: Old: Set_Zeit2_Time != 0, but mil could be 0
                                               //Serial << "Start Next_ExtStartNr:" << Next_ExtStartNr << " Nr:" << Nr << endl; // Debug
                                               }
                                          else {
-                                              mobaLedLib.Set_Input(Contr_Var+2, 1);   // Zeit2 = Zeit_An_Verz  Sofort anschalten damit die Zeit LEDs aufgeblendet werden
-                                              mobaLedLib.Set_Input(DstVar1+Nr,  0);   // Steuervariable fr Day of Year Anzeige ausschalten
-                                              mobaLedLib.Set_Input(Contr_Var+3, 0);   // Flashing blue lights
+                                              Set_Var(mobaLedLib, Contr_Var+2, 1);   // Zeit2 = Zeit_An_Verz  Sofort anschalten damit die Zeit LEDs aufgeblendet werden
+                                              Set_Var(mobaLedLib, DstVar1+Nr,  0);   // Steuervariable fr Day of Year Anzeige ausschalten
+                                              Set_Var(mobaLedLib, Contr_Var+3, 0);   // Flashing blue lights
                                               if (ActiveNr != NO_ACTIVE_NR)
                                                  {
                                                  Next_ExtStartNr++;
@@ -990,22 +3022,21 @@ class RT_Clock : public MLLExtension
                                                  }
                                               }
                                          }
-                                    else mobaLedLib.Set_Input(DstVar1+Nr, Val);
-                                    if (Val) ActiveNr = DstVar1+Nr;
-                                    else     ActiveNr = NO_ACTIVE_NR;
+                                    else Set_Var(mobaLedLib, DstVar1+Nr, Val);
+                                    Set_ActiveNr(Val ? DstVar1+Nr : NO_ACTIVE_NR);
                                     //Serial << "ActiveNr:" << ActiveNr << endl; // Debug
                                     }
 
-                                 if (Set_Zeit2_Time != 0 && mil >= Set_Zeit2_Time && ActiveNr != NO_ACTIVE_NR) // The special display (Birthday) is enabled delayed to be able to dim down the normal time display
+                                 if (Zeit2_Armed && (int32_t)(mil - Set_Zeit2_Time) >= 0 && ActiveNr != NO_ACTIVE_NR) // The special display (Birthday) is enabled delayed to be able to dim down the normal time display
                                     {
-                                    Set_Zeit2_Time = 0;
+                                    Zeit2_Armed = false;
                                     if (Contr_Var_Def)
                                        {
-                                       mobaLedLib.Set_Input(Contr_Var+2,  0); // Zeit2 = Zeit_An_Verz  Verzgert abschalten damit die LEDs abgeblendet werden knnen
-                                       mobaLedLib.Set_Input(ActiveNr,   1);   // Steuervariable fr Day of Year Anzeige anschalten
-                                       //Serial << "Day[" << ActiveNr-DstVar1 << "]=" << Day[ActiveNr-DstVar1] << "  ActiveNr:" << ActiveNr << "  DstVar1:" << DstVar1 << endl;
-                                       if (Day[ActiveNr-DstVar1] != 0) // Enable only if Birthday
-                                          mobaLedLib.Set_Input(Contr_Var+3,  1); // Flashing blue lights
+                                       Set_Var(mobaLedLib, Contr_Var+2,  0); // Zeit2 = Zeit_An_Verz  Verzgert abschalten damit die LEDs abgeblendet werden knnen
+                                       Set_Var(mobaLedLib, ActiveNr,   1);   // Steuervariable fr Day of Year Anzeige anschalten
+                                       //Serial << "ActiveNr:" << ActiveNr << "  DstVar1:" << DstVar1 << endl;
+                                       if (!((Daily_Mask >> (ActiveNr-DstVar1)) & 1)) // Enable only if Birthday
+                                          Set_Var(mobaLedLib, Contr_Var+3,  1); // Flashing blue lights
                                        }
                                     }
                                  }
@@ -1013,7 +3044,9 @@ class RT_Clock : public MLLExtension
                             }
                             return;
         case RTC_CONTR_VAR: return;
-        default: Serial << F("Unhandeled CType in switch:") << CType << endl;
+        case RTC_INC_5MIN:  Adjust_Key(mobaLedLib,  1); return;
+        case RTC_DEC_5MIN:  Adjust_Key(mobaLedLib, -1); return;
+        default: if (RTC_Log.Begin(RTC_LOG_ERR)) RTC_Log << F("Unhandeled CType in switch:") << CType << endl;
                  return;
         }
 
@@ -1023,10 +3056,12 @@ class RT_Clock : public MLLExtension
          if (TempC < RTC_MIN_TEMP-1) TempC = RTC_MIN_TEMP-1;
          if (TempC > RTC_MAX_TEMP+1) TempC = RTC_MAX_TEMP+1;
          //Serial << F("TempC:") << TempC << endl;
-         if (TempC < RTC_MIN_TEMP && (millis() % 2000) > 1000)  TempC = RTC_MIN_TEMP;
+         uint16_t MSec;
+         bool Flash = now_ms(MSec) & 1;  // Toggled with the seconds of the time display
+         if (TempC < RTC_MIN_TEMP && Flash)  TempC = RTC_MIN_TEMP;
          if (TempC > RTC_MAX_TEMP)
             {
-            if ((millis() % 2000) > 1000)  TempC = RTC_MAX_TEMP;
+            if (Flash)  TempC = RTC_MAX_TEMP;
             else                           TempC = RTC_MIN_TEMP-1; // => Val = 0 => Disable the LED for 500 ms
             }
          Val = (TempC - RTC_MIN_TEMP+1);